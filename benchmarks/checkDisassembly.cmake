@@ -0,0 +1,40 @@
+# Checks that every function of the benchmarks named FUNCTION (e.g. the overloads of 'transferTime') compiled to the same instructions. Run as
+#   cmake -DOBJDUMP=<objdump> -DBINARY=<benchmarks> -DFUNCTION=<name> -P checkDisassembly.cmake
+
+if(NOT OBJDUMP)
+    message(STATUS "objdump not found, skipping the disassembly check of ${FUNCTION}")
+    return()
+endif()
+
+execute_process(COMMAND "${OBJDUMP}" -d --no-show-raw-insn -C "${BINARY}" OUTPUT_VARIABLE dump RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Failed to disassemble ${BINARY}")
+endif()
+
+# Each function is a header line '<address> <name(arguments)...>:' followed by its instructions, up to a blank line
+string(REGEX MATCHALL "[0-9a-f]+ <[^\n]*${FUNCTION}\\([^\n]*>:\n([^\n]+\n)*" functions "${dump}")
+list(LENGTH functions count)
+if(count LESS 2)
+    message(FATAL_ERROR "Expected at least 2 functions named ${FUNCTION} in ${BINARY}, found ${count}")
+endif()
+
+# Addresses differ between functions, so the header, the address of each instruction, rip-relative displacements (the absolute target is kept in
+# the comment which follows), and alignment padding are removed. '^' matches again after every replacement in CMake, so lines are matched by the
+# newline which precedes them instead.
+set(expected "")
+foreach(function IN LISTS functions)
+    string(FIND "${function}" "\n" header)
+    string(SUBSTRING "${function}" ${header} -1 code)
+    string(REGEX REPLACE "\n *[0-9a-f]+:\t" "\n" code "${code}")
+    string(REGEX REPLACE "-?0x[0-9a-f]+\\(%rip\\)" "(%rip)" code "${code}")
+    string(REGEX REPLACE "\n(nop|xchg +%ax,%ax|data16)[^\n]*" "" code "${code}")
+
+    if(expected STREQUAL "")
+        set(expected "${code}")
+        set(first "${function}")
+    elseif(NOT code STREQUAL expected)
+        message(FATAL_ERROR "The functions named ${FUNCTION} compiled to different instructions:\n${first}\n${function}")
+    endif()
+endforeach()
+
+message(STATUS "All ${count} functions named ${FUNCTION} compiled to identical instructions")
@@ -0,0 +1,20 @@
+#ifndef BENCHMARKS_BENCHMARKS_H
+#define BENCHMARKS_BENCHMARKS_H
+
+#include "harness.h"
+#include "registry.h"
+
+/**
+ * Each library has its own set of benchmarks in 'src/<library>Benchmarks.cpp', which register themselves at namespace scope, e.g.
+ *
+ *   BENCHMARK("functions/callback/std/invoke/16B", invoke<Std, 2>, callbackCount);
+ *
+ * The arguments initialize a 'bench::Benchmark'. Each registration is a 'constinit' variable which the linker collects into a table (see
+ * "registry.h"), so registering a benchmark costs nothing at startup, and doesn't require changes to any other file.
+ */
+#define BENCHMARK(...) REGISTRY_ADD(benchmarks, bench::Benchmark, __VA_ARGS__)
+
+// Every registered benchmark, in the order of the files which register them, and of the registrations within each file
+registry::Table<bench::Benchmark> registeredBenchmarks();
+
+#endif // BENCHMARKS_BENCHMARKS_H
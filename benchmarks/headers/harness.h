@@ -0,0 +1,140 @@
+#ifndef BENCHMARKS_HARNESS_H
+#define BENCHMARKS_HARNESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "registry.h"
+
+/**
+ * A minimal micro-benchmark harness. Each benchmark is a function which performs the measured operation a requested number of times. The harness:
+ * 1. Calibrates the number of iterations so that a single sample takes at least the configured sample time
+ * 2. Warms up caches, branch predictors, and lazily initialized state by running the benchmark for the configured warmup time
+ * 3. Collects samples until the relative standard error of the mean drops below the target, or the time/sample limit is reached
+ * 4. Reports median, 99th percentile, mean, min, max, and standard deviation of the time per operation
+ * 5. Runs one more sample with allocation counting enabled, and reports the number of calls to the global 'operator new' per operation
+ */
+namespace bench {
+
+  // Performs the measured operation 'iterations' times
+  using Body = void (*)(std::uint64_t iterations);
+
+  struct Benchmark {
+    const char* name;
+    Body body;
+    // Number of logical operations performed by a single iteration (e.g. elements processed); time is reported per operation
+    std::uint64_t items = 1;
+    // Number of bytes processed by a single iteration; if non-zero, throughput is reported in bytes per second
+    std::uint64_t bytes = 0;
+    // If set, the benchmark is skipped (and not listed) unless this returns true, e.g. if it measures instructions which the CPU doesn't support
+    bool (*available)() = nullptr;
+  };
+
+  struct Options {
+    std::string filter;
+    double sampleTimeNs = 1e6;
+    double warmupTimeNs = 1e8;
+    double maxTimeNs = 2e9;
+    std::size_t minSamples = 10;
+    std::size_t maxSamples = 1000;
+    double targetRelativeError = 0.01;
+    bool list = false;
+  };
+
+  struct Result {
+    std::string name;
+    std::uint64_t iterations;
+    std::size_t samples;
+    // All times are in nanoseconds per operation
+    double median;
+    double p99;
+    double mean;
+    double min;
+    double max;
+    double stddev;
+    double relativeError;
+    double itemsPerSecond;
+    double bytesPerSecond;
+    double allocationsPerOp;
+  };
+
+  class Harness {
+
+    registry::Table<Benchmark> benchmarks;
+
+  public:
+
+    explicit Harness(registry::Table<Benchmark> benchmarks);
+
+    Result measure(const Benchmark& benchmark, const Options& options) const;
+
+    // Parses the command line, runs every benchmark matching the filter, and prints the results; returns the process exit code
+    int run(int argc, char* argv[]) const;
+
+  };
+
+  // Forces the compiler to materialize 'value', preventing the computation that produced it from being optimized away
+  template<typename T>
+  inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  // As above, but the compiler must also assume that 'value' was modified (e.g. to prevent devirtualization through a known pointer)
+  template<typename T>
+  inline void doNotOptimize(T& value) {
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+      asm volatile("" : "+r"(value) : : "memory");
+    } else {
+      asm volatile("" : "+m"(value) : : "memory");
+    }
+  }
+
+  // Forces all pending writes to memory to be considered observable
+  inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+  }
+
+  // Destroys the data set kept by 'sharedFixture', e.g. before a benchmark which builds its own data
+  void releaseSharedFixture();
+
+  namespace detail {
+
+    // The fixture kept alive by 'sharedFixture', identified by its type and key
+    struct SharedFixture {
+      std::shared_ptr<void> object;
+      const void* type = nullptr;
+      std::uint64_t key = 0;
+    };
+
+    SharedFixture& currentFixture();
+
+    // Only the address matters: it's unique for each type
+    template<typename F>
+    inline constexpr char fixtureType = 0;
+
+  }
+
+  // The data set of a benchmark, of type 'F', constructed from 'args' unless the previous call was for the same type and key (which tells apart data
+  // sets of the same type, e.g. of different sizes). Only one data set is alive at a time, across all benchmarks: the previous one is destroyed before
+  // the next is constructed, so that the data sets of the largest benchmarks never coexist in memory.
+  template<typename F, typename ... Args>
+  F& sharedFixture(std::uint64_t key, Args&& ... args) {
+
+    detail::SharedFixture& current = detail::currentFixture();
+    if (current.type != &detail::fixtureType<F> || current.key != key) {
+      releaseSharedFixture();
+      current.object = std::make_shared<F>(std::forward<Args>(args)...);
+      current.type = &detail::fixtureType<F>;
+      current.key = key;
+    }
+
+    return *static_cast<F*>(current.object.get());
+  }
+
+}
+
+#endif // BENCHMARKS_HARNESS_H
@@ -0,0 +1,323 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "class.h"
+#include "packedIntArray.h"
+#include "polyCollection.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  // The destructor of ClassN is protected, so it can only be instantiated as a base class sub-object
+  struct BenchClassN : ClassN {
+    using ClassN::ClassN;
+  };
+  
+  void classNConstruct(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      BenchClassN n(static_cast<int>(i));
+      bench::doNotOptimize(n);
+    }
+  }
+  
+  void classNCopy(std::uint64_t iterations) {
+    BenchClassN source(1, 2);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      BenchClassN n(source);
+      bench::doNotOptimize(n);
+    }
+  }
+  
+  void classNCopyAssign(std::uint64_t iterations) {
+    BenchClassN source(1, 2);
+    BenchClassN target;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      target = source;
+      bench::doNotOptimize(target);
+    }
+  }
+  
+  // Grows a vector to 'N' elements without reserving capacity, so that every element is relocated several times as the vector reallocates
+  template<typename T, std::size_t N>
+  void vectorGrowth(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::vector<T> v;
+      for (std::size_t j = 0; j < N; ++j) {
+        v.emplace_back(static_cast<int>(j), static_cast<int>(j));
+      }
+      bench::doNotOptimize(v.data());
+    }
+  }
+  
+  // Calls the virtual 'sum' through a pointer which the compiler cannot see through, so that the call cannot be devirtualized
+  void classDVirtualSum(std::uint64_t iterations) {
+    ClassD d;
+    ClassD* p = &d;
+    int r = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(p);
+      r += p->sum(static_cast<int>(i));
+    }
+    bench::doNotOptimize(r);
+  }
+  
+  // ClassE inherits ClassD with protected inheritance, so only ClassE and its derived classes can convert a ClassE pointer into a ClassD pointer
+  struct BenchClassE : ClassE {
+    ClassD* base() { return this; }
+  };
+  
+  // 10M objects, each randomly a ClassD or a ClassE (or their CRTP counterparts, ClassQ and ClassR), in four layouts
+  constexpr std::size_t objectCount = 10'000'000;
+  
+  template<typename F>
+  void forEachRandomType(F&& f) {
+    std::mt19937_64 random(42);
+    for (std::size_t i = 0; i < objectCount; ++i) {
+      f(random() % 2 == 0);
+    }
+  }
+  
+  // Separately allocated objects, called through base pointers
+  struct PointerObjects {
+    
+    std::vector<std::unique_ptr<ClassD>> ds;
+    std::vector<std::unique_ptr<BenchClassE>> es;
+    std::vector<ClassD*> pointers;
+    
+    PointerObjects() {
+      pointers.reserve(objectCount);
+      forEachRandomType([this](bool d) {
+        if (d) {
+          pointers.push_back(ds.emplace_back(std::make_unique<ClassD>()).get());
+        } else {
+          pointers.push_back(es.emplace_back(std::make_unique<BenchClassE>())->base());
+        }
+      });
+    }
+    
+  };
+  
+  struct PolyObjects {
+    
+    classes::PolyCollection<ClassD, BenchClassE> objects;
+    
+    PolyObjects() {
+      forEachRandomType([this](bool d) { d ? (void) objects.emplace<ClassD>() : (void) objects.emplace<BenchClassE>(); });
+    }
+    
+  };
+  
+  struct CrtpPolyObjects {
+    
+    classes::PolyCollection<ClassQ, ClassR> objects;
+    
+    CrtpPolyObjects() {
+      forEachRandomType([this](bool q) { q ? (void) objects.emplace<ClassQ>() : (void) objects.emplace<ClassR>(); });
+    }
+    
+  };
+  
+  struct CrtpVariantObjects {
+    
+    std::vector<std::variant<ClassQ, ClassR>> objects;
+    
+    CrtpVariantObjects() {
+      objects.reserve(objectCount);
+      forEachRandomType([this](bool q) { q ? (void) objects.emplace_back(ClassQ()) : (void) objects.emplace_back(ClassR()); });
+    }
+    
+  };
+  
+  // Only one of the 10M-object datasets is kept in memory at a time
+  template<typename Objects>
+  Objects& objects() {
+    return bench::sharedFixture<Objects>(0);
+  }
+  
+  void virtualSum(std::uint64_t iterations) {
+    auto& pointers = objects<PointerObjects>().pointers;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long total = 0;
+      for (ClassD* p : pointers) {
+        total += p->sum(1);
+      }
+      bench::doNotOptimize(total);
+    }
+  }
+  
+  // The calls are qualified with the type of each segment, so that they are statically dispatched
+  void polySum(std::uint64_t iterations) {
+    auto& collection = objects<PolyObjects>().objects;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long total = 0;
+      collection.forEach([&total](auto& object) {
+        using T = std::remove_reference_t<decltype(object)>;
+        total += object.T::sum(1);
+      });
+      bench::doNotOptimize(total);
+    }
+  }
+  
+  void crtpPolySum(std::uint64_t iterations) {
+    auto& collection = objects<CrtpPolyObjects>().objects;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long total = 0;
+      collection.forEach([&total](auto& object) { total += object.sum(1); });
+      bench::doNotOptimize(total);
+    }
+  }
+  
+  void crtpVariantSum(std::uint64_t iterations) {
+    auto& variants = objects<CrtpVariantObjects>().objects;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long total = 0;
+      for (auto& v : variants) {
+        total += std::visit([](auto& object) { return object.sum(1); }, v);
+      }
+      bench::doNotOptimize(total);
+    }
+  }
+  
+  // Small values, e.g. enumerations or saturating counters, stored in 'Bits' bits each
+  constexpr std::size_t packedSize = 1'000'000;
+  
+  template<unsigned Bits>
+  const classes::PackedIntArray<Bits>& packedValues() {
+    static const classes::PackedIntArray<Bits> values = [] {
+      classes::PackedIntArray<Bits> v(packedSize);
+      std::mt19937_64 random(Bits);
+      for (std::size_t i = 0; i < packedSize; ++i) {
+        v.set(i, random());
+      }
+      return v;
+    }();
+    return values;
+  }
+  
+  // The same values, one byte each
+  template<unsigned Bits>
+  const std::vector<std::uint8_t>& byteValues() {
+    static const std::vector<std::uint8_t> values = [] {
+      const auto& packed = packedValues<Bits>();
+      std::vector<std::uint8_t> v(packedSize);
+      for (std::size_t i = 0; i < packedSize; ++i) {
+        v[i] = static_cast<std::uint8_t>(packed.get(i));
+      }
+      return v;
+    }();
+    return values;
+  }
+  
+  // Reads the elements in a scattered order (a stride coprime with the size), so that every access computes a new position
+  constexpr std::size_t stride = 7919;
+  
+  template<unsigned Bits>
+  void packedGet(std::uint64_t iterations) {
+    const auto& values = packedValues<Bits>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t sum = 0;
+      for (std::size_t j = 0, k = 0; j < packedSize; ++j, k = (k + stride) % packedSize) {
+        sum += values.get(k);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<unsigned Bits>
+  void byteGet(std::uint64_t iterations) {
+    const auto& values = byteValues<Bits>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t sum = 0;
+      for (std::size_t j = 0, k = 0; j < packedSize; ++j, k = (k + stride) % packedSize) {
+        sum += values[k];
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  // Converts the whole array to 32-bit integers, either one 'get' at a time or with 'unpack'
+  template<unsigned Bits, bool Bulk>
+  void packedUnpack(std::uint64_t iterations) {
+    const auto& values = packedValues<Bits>();
+    std::vector<std::uint32_t> out(packedSize);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      if constexpr (Bulk) {
+        values.unpack(0, std::span(out));
+      } else {
+        for (std::size_t j = 0; j < packedSize; ++j) {
+          out[j] = static_cast<std::uint32_t>(values.get(j));
+        }
+      }
+      bench::doNotOptimize(out.data());
+      bench::clobberMemory();
+    }
+  }
+  
+  template<unsigned Bits, bool Bulk>
+  void packedPack(std::uint64_t iterations) {
+    std::vector<std::uint32_t> in(packedSize);
+    packedValues<Bits>().unpack(0, std::span(in));
+    classes::PackedIntArray<Bits> values(packedSize);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      if constexpr (Bulk) {
+        values.pack(0, std::span(in));
+      } else {
+        for (std::size_t j = 0; j < packedSize; ++j) {
+          values.set(j, in[j]);
+        }
+      }
+      bench::doNotOptimize(values);
+      bench::clobberMemory();
+    }
+  }
+  
+  // Increments every element modulo 2^Bits with 'compareAndSet', uncontended
+  template<unsigned Bits>
+  void packedCompareAndSet(std::uint64_t iterations) {
+    classes::PackedIntArray<Bits> values(packedSize);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      for (std::size_t j = 0; j < packedSize; ++j) {
+        std::uint64_t v = values.load(j);
+        while (!values.compareAndSet(j, v, v + 1)) {
+          v = values.load(j);
+        }
+      }
+      bench::doNotOptimize(values);
+    }
+  }
+  
+}
+
+BENCHMARK("classes/ClassN/construct", classNConstruct);
+BENCHMARK("classes/ClassN/copy", classNCopy);
+BENCHMARK("classes/ClassN/copyAssign", classNCopyAssign);
+BENCHMARK("classes/ClassN/vectorGrowth/1M", vectorGrowth<BenchClassN, 1'000'000>, 1'000'000);
+BENCHMARK("classes/ClassO/vectorGrowth/1M", vectorGrowth<ClassO, 1'000'000>, 1'000'000);
+BENCHMARK("classes/ClassN/vectorGrowth/4M", vectorGrowth<BenchClassN, 4'000'000>, 4'000'000);
+BENCHMARK("classes/ClassO/vectorGrowth/4M", vectorGrowth<ClassO, 4'000'000>, 4'000'000);
+BENCHMARK("classes/ClassD/virtualSum", classDVirtualSum);
+
+BENCHMARK("classes/sum/virtual/10M", virtualSum, objectCount);
+BENCHMARK("classes/sum/polyCollection/10M", polySum, objectCount);
+BENCHMARK("classes/sum/crtp/polyCollection/10M", crtpPolySum, objectCount);
+BENCHMARK("classes/sum/crtp/variant/10M", crtpVariantSum, objectCount);
+
+BENCHMARK("classes/PackedIntArray/3bits/get/1M", packedGet<3>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/byteGet/1M", byteGet<3>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/unpack/loop/1M", packedUnpack<3, false>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/unpack/bulk/1M", packedUnpack<3, true>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/pack/loop/1M", packedPack<3, false>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/pack/bulk/1M", packedPack<3, true>, packedSize);
+BENCHMARK("classes/PackedIntArray/3bits/compareAndSet/1M", packedCompareAndSet<3>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/get/1M", packedGet<5>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/byteGet/1M", byteGet<5>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/unpack/loop/1M", packedUnpack<5, false>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/unpack/bulk/1M", packedUnpack<5, true>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/pack/loop/1M", packedPack<5, false>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/pack/bulk/1M", packedPack<5, true>, packedSize);
+BENCHMARK("classes/PackedIntArray/5bits/compareAndSet/1M", packedCompareAndSet<5>, packedSize);
@@ -0,0 +1,471 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <ext/stdio_filebuf.h>
+#include <ext/stdio_sync_filebuf.h>
+#include <mutex>
+#include <ostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "bytecode.h"
+#include "exceptions.h"
+#include "outputSink.h"
+#include "statements.h"
+#include "threadPool.h"
+#include "threadsafe.h"
+#include "transactional.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  // Standard output carries the report, so output goes to /dev/null instead
+  std::FILE* openNull() {
+    std::FILE* null = std::fopen("/dev/null", "w");
+    if (!null) {
+      throw std::system_error(errno, std::generic_category(), "can't open /dev/null");
+    }
+    return null;
+  }
+  
+  void selection(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      selectionExample();
+    }
+  }
+  
+  // The example writes to a sink on /dev/null
+  void iteration(std::uint64_t iterations) {
+    std::FILE* null = openNull();
+    {
+      output::Sink out(fileno(null));
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        iterationExample(out);
+      }
+    }
+    std::fclose(null);
+  }
+  
+  void jump(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      jumpExample();
+    }
+  }
+  
+  // Also checks the results of every dispatch strategy which this (optimized) build supports
+  void bytecodeStatements(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bytecodeExample();
+    }
+  }
+  
+  void exceptions(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      exceptionCatcher();
+    }
+  }
+  
+  void errorValues(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      resultCatcher();
+    }
+  }
+  
+  // Numbers to parse, of which 'errorsPer100K' in 100'000 are malformed (a digit is replaced by a letter), in random positions
+  constexpr std::size_t tokenCount = 10'000;
+  
+  template<std::size_t ErrorsPer100K>
+  const std::vector<std::string>& tokens() {
+    static const std::vector<std::string> t = [] {
+      std::mt19937_64 random(42);
+      std::vector<std::string> v;
+      for (std::size_t i = 0; i < tokenCount; ++i) {
+        std::string token = std::to_string(random() % 1'000'000);
+        if (random() % 100'000 < ErrorsPer100K) {
+          token[random() % token.size()] = 'x';
+        }
+        v.push_back(std::move(token));
+      }
+      return v;
+    }();
+    return t;
+  }
+  
+  template<std::size_t ErrorsPer100K>
+  void parseThrowing(std::uint64_t iterations) {
+    const std::vector<std::string>& input = tokens<ErrorsPer100K>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long sum = 0;
+      for (const std::string& token : input) {
+        try {
+          sum += exceptionsExample::parseOrThrow(token);
+        } catch (const std::exception& e) {
+          --sum;
+        }
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t ErrorsPer100K>
+  void parseResult(std::uint64_t iterations) {
+    const std::vector<std::string>& input = tokens<ErrorsPer100K>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      long sum = 0;
+      for (const std::string& token : input) {
+        sum += exceptionsExample::parse(token).valueOr(-1);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  // 4 KiB of text in lines of 64 characters
+  constexpr std::size_t textSize = 4'096;
+  
+  const std::string& text() {
+    static const std::string t = [] {
+      std::string s;
+      for (std::size_t i = 0; i < textSize; ++i) {
+        s += (i % 64 == 63) ? '\n' : static_cast<char>('a' + i % 26);
+      }
+      return s;
+    }();
+    return t;
+  }
+  
+  enum class Output { coutSynced, coutUnsynced, sinkChars, sinkLines };
+  
+  // Writes the text to /dev/null. The 'cout' variants use the stream buffers which libstdc++ gives 'std::cout': while synchronized with stdio (the
+  // default), an unbuffered 'stdio_sync_filebuf', which passes every character to 'putc'; after 'sync_with_stdio(false)', a 'stdio_filebuf' with its
+  // own buffer. ('std::cout' itself can't be used, since standard output carries the report.)
+  template<Output O>
+  void writeText(std::uint64_t iterations) {
+    
+    const std::string& t = text();
+    std::FILE* null = openNull();
+    
+    if constexpr (O == Output::coutSynced || O == Output::coutUnsynced) {
+      using Buffer = std::conditional_t<O == Output::coutSynced, __gnu_cxx::stdio_sync_filebuf<char>, __gnu_cxx::stdio_filebuf<char>>;
+      Buffer buffer = [&] {
+        if constexpr (O == Output::coutSynced) {
+          return Buffer(null);
+        } else {
+          return Buffer(null, std::ios_base::out);
+        }
+      }();
+      std::ostream out(&buffer);
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (char c : t) {
+          out << c;
+        }
+      }
+      out.flush();
+    } else {
+      output::Sink out(fileno(null));
+      for (std::uint64_t i = 0; i < iterations; ++i) {
+        if constexpr (O == Output::sinkChars) {
+          for (char c : t) {
+            out << c;
+          }
+        } else {
+          for (std::size_t line = 0; line < textSize; line += 64) {
+            out << std::string_view(t).substr(line, 64);
+          }
+        }
+      }
+    }
+    
+    std::fclose(null);
+  }
+  
+  void synchronized(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      synchronizedExample();
+    }
+  }
+  
+  // With zero increments the thresholds are never exceeded, so this measures the overhead of three uncontended transactions
+  void atomic(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      atomicExample(0, 0, 0);
+    }
+  }
+  
+  // Shared counters, updated together by every thread; each counter is on its own cache line so that only true sharing is measured
+  struct alignas(64) Counter {
+    long value = 0;
+  };
+  
+  Counter i, j, k;
+  std::mutex counterLock;
+  
+  // Per-thread counters, for the uncontended variant
+  Counter privateCounters[64][3];
+  
+  // Splits 'iterations' updates of i, j, and k evenly across 'Threads' threads. If 'Shared' is false, each thread updates its own counters, so
+  // transactions never conflict (but a global mutex still serializes all threads).
+  template<bool Transactional, bool Shared, unsigned Threads>
+  void counters(std::uint64_t iterations) {
+    
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < Threads; ++t) {
+      threads.emplace_back([t, n = (iterations + Threads - 1) / Threads] {
+        Counter& a = Shared ? i : privateCounters[t][0];
+        Counter& b = Shared ? j : privateCounters[t][1];
+        Counter& c = Shared ? k : privateCounters[t][2];
+        
+        for (std::uint64_t u = 0; u < n; ++u) {
+          if constexpr (Transactional) {
+            stm::atomicCommit([&](stm::Transaction& tx) {
+              tx.store(a.value, tx.load(a.value) + 1);
+              tx.store(b.value, tx.load(b.value) + 1);
+              tx.store(c.value, tx.load(c.value) + 1);
+            });
+          } else {
+            std::lock_guard<std::mutex> guard(counterLock);
+            ++a.value;
+            ++b.value;
+            ++c.value;
+          }
+        }
+      });
+    }
+    
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+  
+  
+  std::atomic<std::uint64_t> tasksDone = 0;
+  
+  void tinyTask() {
+    tasksDone.fetch_add(1, std::memory_order_relaxed);
+  }
+  
+  // Runs 'Count' tiny tasks on a pool which outlives the benchmark, so only the cost of submitting and running tasks is measured. The futures are
+  // discarded, and completion is detected through a counter.
+  template<std::uint64_t Count>
+  void pooled(std::uint64_t iterations) {
+    
+    static concurrency::ThreadPool pool;
+    
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      tasksDone.store(0, std::memory_order_relaxed);
+      
+      for (std::uint64_t t = 0; t < Count; ++t) {
+        pool.submit(tinyTask);
+      }
+      
+      while (tasksDone.load(std::memory_order_relaxed) < Count) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  
+  // Runs 'Count' tiny tasks on one OS thread each, with at most one thread per hardware thread alive at a time
+  template<std::uint64_t Count>
+  void spawned(std::uint64_t iterations) {
+    
+    const std::uint64_t batch = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      for (std::uint64_t t = 0; t < Count; t += batch) {
+        for (std::uint64_t u = t; u < std::min(Count, t + batch); ++u) {
+          threads.emplace_back(tinyTask);
+        }
+        
+        for (auto& thread : threads) {
+          thread.join();
+        }
+        threads.clear();
+      }
+    }
+  }
+  
+  
+  // Interpreted programs for the dispatch strategies of "bytecode.h", which do little work per instruction, so that dispatch dominates
+  using bytecode::Op;
+  
+  constexpr std::int32_t loopCount = 10'000;
+  
+  // for (i = 0; i < loopCount; ++i) sum += i; (13 instructions per iteration)
+  const bytecode::Program& loopProgram() {
+    static const bytecode::Program program = [] {
+      constexpr std::int32_t sum = 0, i = 1;
+      bytecode::Assembler a;
+      auto loop = a.label();
+      auto done = a.label();
+      a.bind(loop);
+      a.emit(Op::Load, i).emit(Op::Push, loopCount).emit(Op::Less).jump(Op::JumpIfZero, done);
+      a.emit(Op::Load, sum).emit(Op::Load, i).emit(Op::Add).emit(Op::Store, sum);
+      a.emit(Op::Load, i).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, i).jump(Op::Jump, loop);
+      a.bind(done);
+      a.emit(Op::Load, sum).emit(Op::Halt);
+      return a.finish();
+    }();
+    return program;
+  }
+  
+  constexpr std::int32_t collatzCount = 1'000;
+  
+  // The total number of Collatz steps from each of 1 to 'last' down to 1
+  constexpr std::uint64_t collatzSteps(std::int64_t last) {
+    std::uint64_t steps = 0;
+    for (std::int64_t start = 1; start <= last; ++start) {
+      for (std::int64_t x = start; x != 1; ++steps) {
+        x = (x % 2) ? 3 * x + 1 : x / 2;
+      }
+    }
+    return steps;
+  }
+  
+  // The same as 'collatzSteps(collatzCount)': a data-dependent branch on whether 'x' is odd at every step (18 or 19 instructions per step)
+  const bytecode::Program& collatzProgram() {
+    static const bytecode::Program program = [] {
+      constexpr std::int32_t start = 0, x = 1, steps = 2;
+      bytecode::Assembler a;
+      auto outer = a.label();
+      auto inner = a.label();
+      auto odd = a.label();
+      auto count = a.label();
+      auto next = a.label();
+      auto done = a.label();
+      a.emit(Op::Push, 1).emit(Op::Store, start);
+      a.bind(outer);
+      a.emit(Op::Load, start).emit(Op::Push, collatzCount + 1).emit(Op::Less).jump(Op::JumpIfZero, done);
+      a.emit(Op::Load, start).emit(Op::Store, x);
+      a.bind(inner);
+      a.emit(Op::Load, x).emit(Op::Push, 1).emit(Op::Equal).jump(Op::JumpIfNotZero, next);
+      a.emit(Op::Load, x).emit(Op::Push, 1).emit(Op::BitAnd).jump(Op::JumpIfNotZero, odd);
+      a.emit(Op::Load, x).emit(Op::Push, 1).emit(Op::ShiftRight).emit(Op::Store, x).jump(Op::Jump, count);
+      a.bind(odd);
+      a.emit(Op::Load, x).emit(Op::Push, 3).emit(Op::Multiply).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, x);
+      a.bind(count);
+      a.emit(Op::Load, steps).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, steps).jump(Op::Jump, inner);
+      a.bind(next);
+      a.emit(Op::Load, start).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, start).jump(Op::Jump, outer);
+      a.bind(done);
+      a.emit(Op::Load, steps).emit(Op::Halt);
+      return a.finish();
+    }();
+    return program;
+  }
+  
+  constexpr std::int32_t eventCount = 10'000;
+  
+  // A rule engine: classifies 'eventCount' pseudo-random events with a 'switch' whose cases fall through into each other (as in
+  // 'selectionExample'), and accumulates a score
+  const bytecode::Program& rulesProgram() {
+    static const bytecode::Program program = [] {
+      constexpr std::int32_t x = 0, n = 1, score = 2, kind = 3;
+      bytecode::Assembler a;
+      auto loop = a.label();
+      auto endSwitch = a.label();
+      auto done = a.label();
+      bytecode::Assembler::Label cases[8];
+      a.emit(Op::Push, 1).emit(Op::Store, x);
+      a.bind(loop);
+      a.emit(Op::Load, n).emit(Op::Push, eventCount).emit(Op::Less).jump(Op::JumpIfZero, done);
+      // x = (x * 1103515245 + 12345) & 0x7FFFFFFF; kind = (x >> 16) & 7
+      a.emit(Op::Load, x).emit(Op::Push, 1'103'515'245).emit(Op::Multiply).emit(Op::Push, 12'345).emit(Op::Add);
+      a.emit(Op::Push, 0x7FFFFFFF).emit(Op::BitAnd).emit(Op::Store, x);
+      a.emit(Op::Load, x).emit(Op::Push, 16).emit(Op::ShiftRight).emit(Op::Push, 7).emit(Op::BitAnd).emit(Op::Store, kind);
+      for (std::int32_t c = 0; c < 8; ++c) {
+        cases[c] = a.label();
+        a.emit(Op::Load, kind).emit(Op::Push, c).emit(Op::Equal).jump(Op::JumpIfNotZero, cases[c]);
+      }
+      a.jump(Op::Jump, endSwitch);
+      for (std::int32_t c = 0; c < 8; ++c) {
+        a.bind(cases[c]);
+        a.emit(Op::Load, score).emit(Op::Push, c + 1).emit(Op::Add).emit(Op::Store, score);
+        if (c == 2 || c == 5) {
+          a.jump(Op::Jump, endSwitch);
+        }
+      }
+      a.bind(endSwitch);
+      a.emit(Op::Load, n).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, n).jump(Op::Jump, loop);
+      a.bind(done);
+      a.emit(Op::Load, score).emit(Op::Halt);
+      return a.finish();
+    }();
+    return program;
+  }
+  
+  template<const bytecode::Program& (*Program)(), bytecode::Dispatch D>
+  void interpret(std::uint64_t iterations) {
+    const bytecode::Program& program = Program();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::int64_t result = bytecode::run(program, D);
+      bench::doNotOptimize(result);
+    }
+  }
+  
+  template<bytecode::Dispatch D>
+  bool supported() {
+    return bytecode::isSupported(D);
+  }
+  
+}
+
+BENCHMARK("concepts/selectionExample", selection);
+BENCHMARK("concepts/iterationExample", iteration);
+BENCHMARK("concepts/jumpExample", jump);
+BENCHMARK("concepts/bytecodeExample", bytecodeStatements);
+BENCHMARK("concepts/exceptionCatcher", exceptions);
+BENCHMARK("concepts/resultCatcher", errorValues);
+BENCHMARK("concepts/synchronizedExample", synchronized);
+BENCHMARK("concepts/atomicExample", atomic);
+
+BENCHMARK("concepts/output/cout/synced/char", writeText<Output::coutSynced>, textSize, textSize);
+BENCHMARK("concepts/output/cout/unsynced/char", writeText<Output::coutUnsynced>, textSize, textSize);
+BENCHMARK("concepts/output/sink/char", writeText<Output::sinkChars>, textSize, textSize);
+BENCHMARK("concepts/output/sink/lines", writeText<Output::sinkLines>, textSize, textSize);
+
+BENCHMARK("concepts/parse/throw/0%", parseThrowing<0>, tokenCount);
+BENCHMARK("concepts/parse/result/0%", parseResult<0>, tokenCount);
+BENCHMARK("concepts/parse/throw/0.1%", parseThrowing<100>, tokenCount);
+BENCHMARK("concepts/parse/result/0.1%", parseResult<100>, tokenCount);
+BENCHMARK("concepts/parse/throw/1%", parseThrowing<1'000>, tokenCount);
+BENCHMARK("concepts/parse/result/1%", parseResult<1'000>, tokenCount);
+BENCHMARK("concepts/parse/throw/10%", parseThrowing<10'000>, tokenCount);
+BENCHMARK("concepts/parse/result/10%", parseResult<10'000>, tokenCount);
+
+BENCHMARK("concepts/counters/shared/mutex/1", counters<false, true, 1>);
+BENCHMARK("concepts/counters/shared/stm/1", counters<true, true, 1>);
+BENCHMARK("concepts/counters/shared/mutex/2", counters<false, true, 2>);
+BENCHMARK("concepts/counters/shared/stm/2", counters<true, true, 2>);
+BENCHMARK("concepts/counters/shared/mutex/4", counters<false, true, 4>);
+BENCHMARK("concepts/counters/shared/stm/4", counters<true, true, 4>);
+BENCHMARK("concepts/counters/shared/mutex/8", counters<false, true, 8>);
+BENCHMARK("concepts/counters/shared/stm/8", counters<true, true, 8>);
+BENCHMARK("concepts/counters/private/mutex/4", counters<false, false, 4>);
+BENCHMARK("concepts/counters/private/stm/4", counters<true, false, 4>);
+BENCHMARK("concepts/counters/private/mutex/8", counters<false, false, 8>);
+BENCHMARK("concepts/counters/private/stm/8", counters<true, false, 8>);
+
+// Spawning 10M threads takes minutes, so the spawn-per-task baseline stops at 100K tasks
+BENCHMARK("concepts/tasks/pool/10", pooled<10>, 10);
+BENCHMARK("concepts/tasks/spawn/10", spawned<10>, 10);
+BENCHMARK("concepts/tasks/pool/1K", pooled<1'000>, 1'000);
+BENCHMARK("concepts/tasks/spawn/1K", spawned<1'000>, 1'000);
+BENCHMARK("concepts/tasks/pool/100K", pooled<100'000>, 100'000);
+BENCHMARK("concepts/tasks/spawn/100K", spawned<100'000>, 100'000);
+BENCHMARK("concepts/tasks/pool/10M", pooled<10'000'000>, 10'000'000);
+
+#define BYTECODE_BENCHMARKS(program, items, name)                                                                                                    \
+  BENCHMARK(name "/switch", interpret<program, bytecode::Dispatch::Switch>, items);                                                                  \
+  BENCHMARK(name "/computedGoto", interpret<program, bytecode::Dispatch::ComputedGoto>, items, 0, supported<bytecode::Dispatch::ComputedGoto>);      \
+  BENCHMARK(name "/tailCall", interpret<program, bytecode::Dispatch::TailCall>, items, 0, supported<bytecode::Dispatch::TailCall>)
+
+BYTECODE_BENCHMARKS(loopProgram, loopCount, "concepts/bytecode/loop");
+BYTECODE_BENCHMARKS(collatzProgram, collatzSteps(collatzCount), "concepts/bytecode/collatz");
+BYTECODE_BENCHMARKS(rulesProgram, eventCount, "concepts/bytecode/rules");
+
+#undef BYTECODE_BENCHMARKS
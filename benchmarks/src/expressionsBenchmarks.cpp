@@ -0,0 +1,474 @@
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena.h"
+#include "arithmeticOperators.h"
+#include "bulkOperators.h"
+#include "dynamicMemory.h"
+#include "numberParser.h"
+#include "units.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  void arithmeticOperators(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      arithmeticOperatorsExample();
+    }
+  }
+  
+  void bulkOperators(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bulkOperatorsExample();
+    }
+  }
+  
+  // The operands and results of 'bulkKernel'. The right-hand operands are small and non-zero, so that they are valid divisors and shift counts.
+  template<typename T>
+  struct BulkArrays {
+    
+    std::vector<T> a, b, out;
+    
+    explicit BulkArrays(std::size_t n): a(n), b(n), out(n) {
+      for (std::size_t i = 0; i < n; ++i) {
+        a[i] = T(i * 2654435761u);
+        b[i] = T(1 + i % 7);
+      }
+    }
+    
+  };
+  
+  // Applies 'Op' to two arrays of 'N' elements with the given instruction set. The arrays are built once, and shared by every operator and
+  // instruction set with the same element type and size.
+  template<bulk::Operator Op, typename T, std::size_t N, bulk::Isa I>
+  void bulkKernel(std::uint64_t iterations) {
+    
+    auto& [a, b, out] = bench::sharedFixture<BulkArrays<T>>(N, N);
+    
+    bulk::setActiveIsa(I);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bulk::apply<Op, T>(a, b, out);
+      bench::clobberMemory();
+    }
+    bulk::setActiveIsa(bulk::detectedIsa());
+  }
+  
+  template<bulk::Isa I>
+  bool supported() {
+    return bulk::isSupported(I);
+  }
+  
+  void dynamicMemory(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      dynamicMemoryExample();
+    }
+  }
+  
+  void dynamicMemoryArena(std::uint64_t iterations) {
+    static arena::Arena a;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      dynamicMemoryArenaExample(a);
+    }
+  }
+  
+  // Allocates 'Count' objects of 'Size' bytes, then frees all of them
+  template<std::size_t Size, std::size_t Count>
+  void globalNewDelete(std::uint64_t iterations) {
+    static void* pointers[Count];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      for (std::size_t j = 0; j < Count; ++j) {
+        pointers[j] = ::operator new(Size);
+        bench::doNotOptimize(pointers[j]);
+      }
+      for (std::size_t j = 0; j < Count; ++j) {
+        ::operator delete(pointers[j], Size);
+      }
+    }
+  }
+  
+  template<std::size_t Size, std::size_t Count>
+  void arenaAllocate(std::uint64_t iterations) {
+    static arena::Arena a;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      arena::Scope scope(a);
+      for (std::size_t j = 0; j < Count; ++j) {
+        void* p = a.allocate(Size);
+        bench::doNotOptimize(p);
+      }
+    }
+  }
+  
+  // The time to transfer 'request' bytes over a link which transferred 'transferred' bytes in 'elapsed' seconds, plus a fixed round trip. The two
+  // versions must compile to identical instructions; they are not inlined, so that the build can compare their code (see "checkDisassembly.cmake")
+  [[gnu::noinline]] double transferTime(double transferred, double elapsed, double request) {
+    double rate = transferred / elapsed;
+    return request / rate + 250e-6;
+  }
+  
+  [[gnu::noinline]] units::Time transferTime(units::Data transferred, units::Time elapsed, units::Data request) {
+    using namespace units::literals;
+    units::DataRate rate = transferred / elapsed;
+    return request / rate + 250_us;
+  }
+  
+  // Samples of transferred bytes and elapsed times, so that the arithmetic can't be folded
+  constexpr std::size_t sampleCount = 1'024;
+  
+  struct TransferSamples {
+    
+    std::vector<double> transferred, elapsed;
+    
+    TransferSamples(): transferred(sampleCount), elapsed(sampleCount) {
+      for (std::size_t i = 0; i < sampleCount; ++i) {
+        transferred[i] = static_cast<double>(1'000'000 + 4'096 * i);
+        elapsed[i] = 1e-3 * static_cast<double>(1 + i % 17);
+      }
+    }
+    
+  };
+  
+  template<bool Typed>
+  void transferTimes(std::uint64_t iterations) {
+    
+    auto& [transferred, elapsed] = bench::sharedFixture<TransferSamples>(0);
+    
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      double sum = 0;
+      for (std::size_t j = 0; j < sampleCount; ++j) {
+        if constexpr (Typed) {
+          sum += transferTime(transferred[j] * units::byte, elapsed[j] * units::second, 4'096 * units::byte).in(units::second);
+        } else {
+          sum += transferTime(transferred[j], elapsed[j], 4'096);
+        }
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  // Numeric text is generated at compile time, so that its size (and therefore the throughput of parsing it) is a constant: 'numberCount' numbers,
+  // each followed by a newline
+  constexpr std::size_t numberCount = 4'096;
+  
+  enum class NumberText {
+    // Decimal integers of 1 to 19 digits (all of which fit into 'long long')
+    integers,
+    // Decimal fractions with up to 16 significant digits, a quarter of them with an exponent
+    doubles,
+    // Every form of numeric literal in 'printLiterals', with separators and suffixes
+    literals
+  };
+  
+  struct Random {
+    std::uint64_t state;
+    
+    constexpr unsigned next(unsigned bound) {
+      state = state * 6'364'136'223'846'793'005ULL + 1'442'695'040'888'963'407ULL;
+      return static_cast<unsigned>((state >> 33) % bound);
+    }
+  };
+  
+  // Writes the text to 'out', or only counts its characters if 'out' is null; returns the number of characters
+  template<NumberText Kind>
+  constexpr std::size_t writeNumbers(char* out) {
+    
+    std::size_t size = 0;
+    auto put = [&](char c) {
+      if (out) {
+        out[size] = c;
+      }
+      ++size;
+    };
+    auto digits = [&](Random& r, unsigned count, unsigned base) {
+      for (unsigned i = 0; i < count; ++i) {
+        put("0123456789abcdef"[(i == 0 && base == 10) ? 1 + r.next(8) : r.next(base)]);
+      }
+    };
+    
+    Random r{42};
+    for (std::size_t n = 0; n < numberCount; ++n) {
+      if constexpr (Kind == NumberText::integers) {
+        digits(r, 1 + r.next(19), 10);
+      } else if constexpr (Kind == NumberText::doubles) {
+        digits(r, 1 + r.next(6), 10);
+        put('.');
+        digits(r, 1 + r.next(10), 10);
+        if (r.next(4) == 0) {
+          put('e');
+          put(r.next(2) ? '-' : '+');
+          digits(r, 1 + r.next(2), 10);
+        }
+      } else {
+        switch (r.next(7)) {
+          case 0:
+            digits(r, 1 + r.next(3), 10);
+            put('\'');
+            digits(r, 3, 10);
+            break;
+          case 1:
+            put('0');
+            digits(r, 1 + r.next(10), 8);
+            break;
+          case 2:
+            put('0');
+            put('x');
+            digits(r, 1 + r.next(15), 16);
+            break;
+          case 3:
+            put('0');
+            put('b');
+            digits(r, 1 + r.next(32), 2);
+            break;
+          case 4:
+            digits(r, 1 + r.next(9), 10);
+            put('U');
+            put('L');
+            break;
+          case 5:
+            digits(r, 1 + r.next(3), 10);
+            put('e');
+            digits(r, 1 + r.next(2), 10);
+            break;
+          default:
+            put('0');
+            put('x');
+            digits(r, 1 + r.next(4), 16);
+            put('.');
+            digits(r, 1 + r.next(4), 16);
+            put('p');
+            digits(r, 1, 10);
+            break;
+        }
+      }
+      put('\n');
+    }
+    return size;
+  }
+  
+  template<NumberText Kind>
+  constexpr auto numberText = [] {
+    std::array<char, writeNumbers<Kind>(nullptr)> text{};
+    writeNumbers<Kind>(text.data());
+    return text;
+  }();
+  
+  [[noreturn]] void misread(const char* parser, std::size_t n) {
+    throw std::logic_error(std::string("expressions/numbers: ") + parser + " misread number " + std::to_string(n) + " of the text");
+  }
+  
+  // Checks that every parser reads every number of the text in the same way (without an error), since a faster parser might just be a wrong one.
+  // Runs once, before the first of the 'expressions/numbers' benchmarks, outside of their timed loops.
+  void checkNumbers() {
+    
+    static const bool checked = [] {
+      
+      const auto& integers = numberText<NumberText::integers>;
+      const char* p = integers.data();
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        char* end;
+        long long expected = std::strtoll(p, &end, 10);
+        long long value = 0;
+        auto [ptr, ec] = std::from_chars(p, integers.data() + integers.size(), value);
+        if (ec != std::errc{} || ptr != end || value != expected) {
+          misread("std::from_chars", n);
+        }
+        numbers::Number number;
+        numbers::Parsed parsed = numbers::parse(p, integers.data() + integers.size(), number);
+        if (parsed.ec != std::errc{} || parsed.ptr != end || number.integer != static_cast<std::uint64_t>(expected)) {
+          misread("numbers::parse", n);
+        }
+        p = end + 1;
+      }
+      
+      const auto& doubles = numberText<NumberText::doubles>;
+      p = doubles.data();
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        char* end;
+        double expected = std::strtod(p, &end);
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(p, doubles.data() + doubles.size(), value);
+        if (ec != std::errc{} || ptr != end || value != expected) {
+          misread("std::from_chars", n);
+        }
+        numbers::Number number;
+        numbers::Parsed parsed = numbers::parse(p, doubles.data() + doubles.size(), number);
+        if (parsed.ec != std::errc{} || parsed.ptr != end || number.floating != expected) {
+          misread("numbers::parse", n);
+        }
+        p = end + 1;
+      }
+      
+      // 'parseAll' must find every number, including the literals, which the C library can't parse
+      std::vector<numbers::Number> parsed;
+      for (std::string_view text : {std::string_view(integers.data(), integers.size()), std::string_view(doubles.data(), doubles.size()),
+                                    std::string_view(numberText<NumberText::literals>.data(), numberText<NumberText::literals>.size())}) {
+        parsed.clear();
+        if (numbers::parseAll(text, parsed).ec != std::errc{} || parsed.size() != numberCount) {
+          misread("numbers::parseAll", parsed.size());
+        }
+      }
+      
+      return true;
+    }();
+    
+    static_cast<void>(checked);
+  }
+  
+  void integersStrtoll(std::uint64_t iterations) {
+    checkNumbers();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = numberText<NumberText::integers>.data();
+      long long sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        char* end;
+        sum += std::strtoll(p, &end, 10);
+        p = end;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void integersFromChars(std::uint64_t iterations) {
+    checkNumbers();
+    const auto& text = numberText<NumberText::integers>;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = text.data();
+      long long sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        long long value = 0;
+        p = std::from_chars(p, text.data() + text.size(), value).ptr + 1;
+        sum += value;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void integersParse(std::uint64_t iterations) {
+    checkNumbers();
+    const auto& text = numberText<NumberText::integers>;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = text.data();
+      std::uint64_t sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        numbers::Number value;
+        p = numbers::parse(p, text.data() + text.size(), value).ptr + 1;
+        sum += value.integer;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void doublesStrtod(std::uint64_t iterations) {
+    checkNumbers();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = numberText<NumberText::doubles>.data();
+      double sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        char* end;
+        sum += std::strtod(p, &end);
+        p = end;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void doublesFromChars(std::uint64_t iterations) {
+    checkNumbers();
+    const auto& text = numberText<NumberText::doubles>;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = text.data();
+      double sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        double value = 0;
+        p = std::from_chars(p, text.data() + text.size(), value).ptr + 1;
+        sum += value;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void doublesParse(std::uint64_t iterations) {
+    checkNumbers();
+    const auto& text = numberText<NumberText::doubles>;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      const char* p = text.data();
+      double sum = 0;
+      for (std::size_t n = 0; n < numberCount; ++n) {
+        numbers::Number value;
+        p = numbers::parse(p, text.data() + text.size(), value).ptr + 1;
+        sum += value.floating;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<NumberText Kind>
+  void parseAll(std::uint64_t iterations) {
+    checkNumbers();
+    static std::vector<numbers::Number> parsed;
+    const std::string_view text(numberText<Kind>.data(), numberText<Kind>.size());
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      parsed.clear();
+      numbers::parseAll(text, parsed);
+      bench::doNotOptimize(parsed.data());
+    }
+  }
+  
+}
+
+BENCHMARK("expressions/arithmeticOperatorsExample", arithmeticOperators);
+BENCHMARK("expressions/bulkOperatorsExample", bulkOperators);
+BENCHMARK("expressions/dynamicMemoryExample", dynamicMemory);
+BENCHMARK("expressions/dynamicMemoryArenaExample", dynamicMemoryArena);
+
+BENCHMARK("expressions/units/transferTime/double", transferTimes<false>, sampleCount);
+BENCHMARK("expressions/units/transferTime/quantity", transferTimes<true>, sampleCount);
+
+BENCHMARK("expressions/numbers/integers/strtoll", integersStrtoll, numberCount, numberText<NumberText::integers>.size());
+BENCHMARK("expressions/numbers/integers/fromChars", integersFromChars, numberCount, numberText<NumberText::integers>.size());
+BENCHMARK("expressions/numbers/integers/parse", integersParse, numberCount, numberText<NumberText::integers>.size());
+BENCHMARK("expressions/numbers/integers/parseAll", parseAll<NumberText::integers>, numberCount, numberText<NumberText::integers>.size());
+BENCHMARK("expressions/numbers/doubles/strtod", doublesStrtod, numberCount, numberText<NumberText::doubles>.size());
+BENCHMARK("expressions/numbers/doubles/fromChars", doublesFromChars, numberCount, numberText<NumberText::doubles>.size());
+BENCHMARK("expressions/numbers/doubles/parse", doublesParse, numberCount, numberText<NumberText::doubles>.size());
+BENCHMARK("expressions/numbers/doubles/parseAll", parseAll<NumberText::doubles>, numberCount, numberText<NumberText::doubles>.size());
+BENCHMARK("expressions/numbers/literals/parseAll", parseAll<NumberText::literals>, numberCount, numberText<NumberText::literals>.size());
+
+BENCHMARK("expressions/allocation/newDelete/16B/x1", globalNewDelete<16, 1>, 1);
+BENCHMARK("expressions/allocation/arena/16B/x1", arenaAllocate<16, 1>, 1);
+BENCHMARK("expressions/allocation/newDelete/16B/x1000", globalNewDelete<16, 1000>, 1000);
+BENCHMARK("expressions/allocation/arena/16B/x1000", arenaAllocate<16, 1000>, 1000);
+BENCHMARK("expressions/allocation/newDelete/256B/x1", globalNewDelete<256, 1>, 1);
+BENCHMARK("expressions/allocation/arena/256B/x1", arenaAllocate<256, 1>, 1);
+BENCHMARK("expressions/allocation/newDelete/256B/x1000", globalNewDelete<256, 1000>, 1000);
+BENCHMARK("expressions/allocation/arena/256B/x1000", arenaAllocate<256, 1000>, 1000);
+BENCHMARK("expressions/allocation/newDelete/4KiB/x1", globalNewDelete<4096, 1>, 1);
+BENCHMARK("expressions/allocation/arena/4KiB/x1", arenaAllocate<4096, 1>, 1);
+BENCHMARK("expressions/allocation/newDelete/4KiB/x1000", globalNewDelete<4096, 1000>, 1000);
+BENCHMARK("expressions/allocation/arena/4KiB/x1000", arenaAllocate<4096, 1000>, 1000);
+BENCHMARK("expressions/allocation/newDelete/64KiB/x100", globalNewDelete<65536, 100>, 100);
+BENCHMARK("expressions/allocation/arena/64KiB/x100", arenaAllocate<65536, 100>, 100);
+
+// Registers 'bulkKernel' for every instruction set; those which this CPU doesn't support are skipped
+#define BULK_BENCHMARKS(Op, T, N, name)                                                                                                          \
+  BENCHMARK(name "/scalar", bulkKernel<Op, T, N, bulk::Isa::Scalar>, N, 3 * N * sizeof(T), supported<bulk::Isa::Scalar>);                       \
+  BENCHMARK(name "/sse2", bulkKernel<Op, T, N, bulk::Isa::SSE2>, N, 3 * N * sizeof(T), supported<bulk::Isa::SSE2>);                             \
+  BENCHMARK(name "/avx2", bulkKernel<Op, T, N, bulk::Isa::AVX2>, N, 3 * N * sizeof(T), supported<bulk::Isa::AVX2>);                             \
+  BENCHMARK(name "/avx512", bulkKernel<Op, T, N, bulk::Isa::AVX512>, N, 3 * N * sizeof(T), supported<bulk::Isa::AVX512>)
+
+BULK_BENCHMARKS(bulk::Operator::Plus, std::uint32_t, 4'096, "expressions/bulk/add/u32/4K");
+BULK_BENCHMARKS(bulk::Operator::Plus, std::uint32_t, 16'777'216, "expressions/bulk/add/u32/16M");
+BULK_BENCHMARKS(bulk::Operator::Multiplies, std::uint8_t, 4'096, "expressions/bulk/multiply/u8/4K");
+BULK_BENCHMARKS(bulk::Operator::Multiplies, std::uint64_t, 4'096, "expressions/bulk/multiply/u64/4K");
+BULK_BENCHMARKS(bulk::Operator::ShiftLeft, std::int16_t, 4'096, "expressions/bulk/shiftLeft/i16/4K");
+BULK_BENCHMARKS(bulk::Operator::BitXor, std::uint64_t, 4'096, "expressions/bulk/bitXor/u64/4K");
+BULK_BENCHMARKS(bulk::Operator::Divides, float, 4'096, "expressions/bulk/divide/f32/4K");
+
+#undef BULK_BENCHMARKS
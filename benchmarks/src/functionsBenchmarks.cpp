@@ -0,0 +1,95 @@
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "inplaceFunction.h"
+#include "lambda.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  void lambda(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      lambdaExample();
+    }
+  }
+  
+  // A closure which captures 'Words' 8-byte values: 2 words fit into the local buffer of 'std::function', 5 don't
+  template<std::size_t Words>
+  auto makeClosure(std::uint64_t seed) {
+    std::array<std::uint64_t, Words> captures;
+    for (std::size_t w = 0; w < Words; ++w) {
+      captures[w] = seed + w;
+    }
+    return [captures](std::uint64_t x) { return x + captures[x % Words]; };
+  }
+  
+  using Std = std::function<std::uint64_t(std::uint64_t)>;
+  using Inplace = callbacks::InplaceFunction<std::uint64_t(std::uint64_t), 48>;
+  using Ref = callbacks::FunctionRef<std::uint64_t(std::uint64_t)>;
+  
+  template<typename Function, std::size_t Words>
+  void construct(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      Function f = makeClosure<Words>(i);
+      bench::doNotOptimize(f);
+    }
+  }
+  
+  // Calls a set of distinct callbacks in turn, as an event dispatcher would
+  constexpr std::size_t callbackCount = 1'000;
+  
+  template<typename Function, std::size_t Words>
+  void invoke(std::uint64_t iterations) {
+    
+    std::vector<Function> callbacks;
+    for (std::size_t c = 0; c < callbackCount; ++c) {
+      callbacks.emplace_back(makeClosure<Words>(c));
+    }
+    
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t sum = 0;
+      for (const Function& f : callbacks) {
+        sum += f(sum);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t Words>
+  void invokeRef(std::uint64_t iterations) {
+    
+    using Closure = decltype(makeClosure<Words>(0));
+    std::vector<Closure> closures;
+    std::vector<Ref> callbacks;
+    closures.reserve(callbackCount);
+    for (std::size_t c = 0; c < callbackCount; ++c) {
+      callbacks.emplace_back(closures.emplace_back(makeClosure<Words>(c)));
+    }
+    
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t sum = 0;
+      for (const Ref& f : callbacks) {
+        sum += f(sum);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+}
+
+BENCHMARK("functions/lambdaExample", lambda);
+
+BENCHMARK("functions/callback/std/construct/16B", construct<Std, 2>);
+BENCHMARK("functions/callback/inplace/construct/16B", construct<Inplace, 2>);
+BENCHMARK("functions/callback/std/construct/40B", construct<Std, 5>);
+BENCHMARK("functions/callback/inplace/construct/40B", construct<Inplace, 5>);
+
+BENCHMARK("functions/callback/std/invoke/16B", invoke<Std, 2>, callbackCount);
+BENCHMARK("functions/callback/inplace/invoke/16B", invoke<Inplace, 2>, callbackCount);
+BENCHMARK("functions/callback/ref/invoke/16B", invokeRef<2>, callbackCount);
+BENCHMARK("functions/callback/std/invoke/40B", invoke<Std, 5>, callbackCount);
+BENCHMARK("functions/callback/inplace/invoke/40B", invoke<Inplace, 5>, callbackCount);
+BENCHMARK("functions/callback/ref/invoke/40B", invokeRef<5>, callbackCount);
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+#include "harness.h"
+
+namespace bench {
+
+  namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Allocations are only counted during the dedicated counting run, so that the measured samples do not pay for the atomic increment
+    std::atomic<bool> countingAllocations = false;
+    std::atomic<std::uint64_t> allocationCount = 0;
+
+    // Many examples print to 'std::cout'; their output is discarded while they are being measured so that the report remains readable
+    struct NullBuffer : std::streambuf {
+      int overflow(int c) override { return traits_type::not_eof(c); }
+      std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    double timeRun(Body body, std::uint64_t iterations) {
+
+      auto start = Clock::now();
+      body(iterations);
+      auto end = Clock::now();
+
+      return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+
+      auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+      return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    bool parseMillis(std::string_view arg, std::string_view flag, double& out) {
+
+      if (!arg.starts_with(flag)) {
+        return false;
+      }
+
+      out = std::strtod(std::string(arg.substr(flag.size())).c_str(), nullptr) * 1e6;
+      return true;
+    }
+
+    void printEscaped(std::ostream& os, std::string_view s) {
+
+      for (char c : s) {
+        if (c == '"' || c == '\\') {
+          os << '\\';
+        }
+        os << c;
+      }
+    }
+
+    void printUsage(const char* program) {
+
+      std::cerr << "Usage: " << program << " [options]\n"
+                << "  --filter=<text>      run only benchmarks whose name contains <text>, or matches it if it contains '*' or '?'\n"
+                << "  --list               list the registered benchmarks and exit\n"
+                << "  --sample-time=<ms>   minimum duration of a single sample (default 1)\n"
+                << "  --warmup=<ms>        warmup duration per benchmark (default 100)\n"
+                << "  --max-time=<ms>      maximum measurement duration per benchmark (default 2000)\n";
+    }
+
+  }
+
+  void releaseSharedFixture() {
+    detail::SharedFixture& current = detail::currentFixture();
+    current.object.reset();
+    current.type = nullptr;
+  }
+
+  detail::SharedFixture& detail::currentFixture() {
+    static SharedFixture current;
+    return current;
+  }
+
+  Harness::Harness(registry::Table<Benchmark> benchmarks): benchmarks(benchmarks) {}
+
+  Result Harness::measure(const Benchmark& benchmark, const Options& options) const {
+
+    // Calibration: grow the iteration count until a single run takes at least the sample time. The growth is bounded at each step, since the cost
+    // of a run is not necessarily proportional to the iteration count (e.g. benchmarks which start threads have a fixed cost per run).
+    std::uint64_t iterations = 1;
+    double elapsed = timeRun(benchmark.body, iterations);
+    double warmedUp = elapsed;
+    while (elapsed < options.sampleTimeNs) {
+      double scale = std::clamp(1.2 * options.sampleTimeNs / std::max(elapsed, 1.0), 2.0, 10.0);
+      iterations = static_cast<std::uint64_t>(std::ceil(iterations * scale));
+      elapsed = timeRun(benchmark.body, iterations);
+      warmedUp += elapsed;
+    }
+
+    // Warmup
+    while (warmedUp < options.warmupTimeNs) {
+      warmedUp += timeRun(benchmark.body, iterations);
+    }
+
+    // Measurement: keep sampling until the mean is known to within the target relative error
+    const double operations = static_cast<double>(iterations) * benchmark.items;
+    std::vector<double> samples;
+    double total = 0.0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    double relativeError = 1.0;
+
+    while (samples.size() < options.maxSamples) {
+
+      double perOperation = timeRun(benchmark.body, iterations) / operations;
+      samples.push_back(perOperation);
+      total += perOperation * operations;
+      sum += perOperation;
+      sumSquares += perOperation * perOperation;
+
+      auto n = static_cast<double>(samples.size());
+      double mean = sum / n;
+      double variance = (n > 1) ? std::max(0.0, (sumSquares - n * mean * mean) / (n - 1)) : 0.0;
+      relativeError = (n > 1 && mean > 0) ? std::sqrt(variance / n) / mean : 1.0;
+
+      // Benchmarks whose samples take a large fraction of the time limit settle for fewer samples
+      bool converged = samples.size() >= options.minSamples && relativeError <= options.targetRelativeError;
+      bool timedOut = total >= options.maxTimeNs && samples.size() >= std::min<std::size_t>(options.minSamples, 3);
+      if (converged || timedOut) {
+        break;
+      }
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto n = static_cast<double>(samples.size());
+    double mean = sum / n;
+    double variance = (n > 1) ? std::max(0.0, (sumSquares - n * mean * mean) / (n - 1)) : 0.0;
+
+    Result r;
+    r.name = benchmark.name;
+    r.iterations = iterations;
+    r.samples = samples.size();
+    r.median = percentile(sorted, 0.5);
+    r.p99 = percentile(sorted, 0.99);
+    r.mean = mean;
+    r.min = sorted.front();
+    r.max = sorted.back();
+    r.stddev = std::sqrt(variance);
+    r.relativeError = relativeError;
+    r.itemsPerSecond = 1e9 / r.median;
+    r.bytesPerSecond = benchmark.bytes ? (1e9 / r.median) * benchmark.bytes / benchmark.items : 0.0;
+
+    allocationCount = 0;
+    countingAllocations = true;
+    benchmark.body(iterations);
+    countingAllocations = false;
+    r.allocationsPerOp = allocationCount / operations;
+
+    return r;
+  }
+
+  int Harness::run(int argc, char* argv[]) const {
+
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+
+      if (arg.starts_with("--filter=")) {
+        options.filter = arg.substr(9);
+      } else if (arg == "--list") {
+        options.list = true;
+      } else if (parseMillis(arg, "--sample-time=", options.sampleTimeNs) || parseMillis(arg, "--warmup=", options.warmupTimeNs)
+                 || parseMillis(arg, "--max-time=", options.maxTimeNs)) {
+        continue;
+      } else {
+        printUsage(argv[0]);
+        return (arg == "--help") ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+    }
+
+    std::vector<const Benchmark*> selected;
+    for (const auto& r : benchmarks) {
+      const Benchmark& b = r.entry;
+      if (registry::matches(options.filter, b.name) && (!b.available || b.available())) {
+        selected.push_back(&b);
+      }
+    }
+
+    if (options.list) {
+      for (const Benchmark* b : selected) {
+        std::cout << b->name << '\n';
+      }
+      return EXIT_SUCCESS;
+    }
+
+    NullBuffer null;
+    std::vector<Result> results;
+
+    for (const Benchmark* b : selected) {
+      std::streambuf* out = std::cout.rdbuf(&null);
+      Result r = measure(*b, options);
+      std::cout.rdbuf(out);
+
+      std::fprintf(stderr, "%-56s %12.2f ns/op (p99 %12.2f) %10.2f allocs/op %10zu samples%s\n", r.name.c_str(), r.median, r.p99,
+                   r.allocationsPerOp, r.samples, (r.relativeError <= options.targetRelativeError) ? "" : " [unstable]");
+      results.push_back(r);
+    }
+
+    // Machine-readable report
+    std::cout << "{\n  \"context\": {\"compiler\": \"";
+    printEscaped(std::cout, __VERSION__);
+    std::cout << "\", \"sample_time_ns\": " << options.sampleTimeNs << ", \"warmup_time_ns\": " << options.warmupTimeNs << "},\n";
+    std::cout << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      const Result& r = results[i];
+
+      std::cout << (i ? "," : "") << "\n    {\"name\": \"";
+      printEscaped(std::cout, r.name);
+      std::cout << "\", \"iterations\": " << r.iterations << ", \"samples\": " << r.samples
+                << ", \"ns_per_op\": {\"median\": " << r.median << ", \"p99\": " << r.p99 << ", \"mean\": " << r.mean << ", \"min\": " << r.min
+                << ", \"max\": " << r.max << ", \"stddev\": " << r.stddev << "}"
+                << ", \"relative_error\": " << r.relativeError << ", \"items_per_second\": " << r.itemsPerSecond << ", \"allocations_per_op\": " << r.allocationsPerOp;
+      if (r.bytesPerSecond > 0) {
+        std::cout << ", \"bytes_per_second\": " << r.bytesPerSecond;
+      }
+      std::cout << "}";
+    }
+    std::cout << "\n  ]\n}\n";
+
+    return EXIT_SUCCESS;
+  }
+
+}
+
+// Replacements of the global allocation functions, which count allocations while counting is enabled. The array and nothrow forms provided by the
+// standard library are implemented in terms of these; the aligned forms (used for over-aligned types, e.g. 'alignment::CacheAligned') are not, since
+// libstdc++ implements them with 'aligned_alloc', so they are replaced as well.
+namespace {
+
+  void countAllocation() {
+    if (bench::countingAllocations.load(std::memory_order_relaxed)) [[unlikely]] {
+      bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+}
+
+void* operator new(std::size_t size) {
+
+  countAllocation();
+
+  if (void* p = std::malloc(size ? size : 1)) [[likely]] {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+
+  countAllocation();
+
+  // 'aligned_alloc' requires the size to be a multiple of the alignment
+  auto a = static_cast<std::size_t>(alignment);
+  std::size_t rounded = (size + a - 1) & ~(a - 1);
+  if (void* p = (rounded >= size) ? std::aligned_alloc(a, rounded ? rounded : a) : nullptr) [[likely]] {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
@@ -0,0 +1,10 @@
+#include "benchmarks.h"
+
+REGISTRY_DEFINE_TABLE(registeredBenchmarks, benchmarks, bench::Benchmark)
+
+int main(int argc, char *argv[]) {
+  
+  bench::Harness harness(registeredBenchmarks());
+  
+  return harness.run(argc, argv);
+}
@@ -0,0 +1,267 @@
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cacheAligned.h"
+#include "interner.h"
+#include "lookupTables.h"
+
+#include "benchmarks.h"
+
+namespace {
+
+  // Arguments cycle through a fixed set of values, so that the lookups can't be hoisted out of the loop
+  constexpr std::size_t argumentCount = 1024;
+
+  std::array<std::uint64_t, argumentCount> randomArguments() {
+
+    std::array<std::uint64_t, argumentCount> arguments;
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto& a : arguments) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      a = state;
+    }
+
+    return arguments;
+  }
+
+  const std::array<std::uint64_t, argumentCount> arguments = randomArguments();
+
+  // The recursive factorial of "specifiers.cpp", evaluated at runtime
+  std::uint64_t recursiveFactorial(unsigned n) {
+    return (n <= 1) ? 1 : (n * recursiveFactorial(n - 1));
+  }
+
+  std::uint64_t recursiveBinomial(unsigned n, unsigned k) {
+    return (k == 0 || k == n) ? 1 : recursiveBinomial(n - 1, k - 1) + recursiveBinomial(n - 1, k);
+  }
+
+  std::uint32_t bitwiseCrc32(const std::uint8_t* data, std::size_t size) {
+
+    std::uint32_t crc = ~std::uint32_t(0);
+    for (std::size_t i = 0; i < size; ++i) {
+      crc ^= data[i];
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 1) ? (crc >> 1) ^ tables::crc32Polynomial : crc >> 1;
+      }
+    }
+
+    return ~crc;
+  }
+
+  unsigned loopPopcount(std::uint64_t x) {
+    unsigned count = 0;
+    for (; x; x &= x - 1) {
+      ++count;
+    }
+    return count;
+  }
+
+  std::uint64_t loopReverseBits(std::uint64_t x) {
+    std::uint64_t reversed = 0;
+    for (int bit = 0; bit < 64; ++bit, x >>= 1) {
+      reversed = (reversed << 1) | (x & 1);
+    }
+    return reversed;
+  }
+
+  template<bool Table>
+  void factorial(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      auto n = static_cast<unsigned>(arguments[i % argumentCount] % 21);
+      bench::doNotOptimize(Table ? tables::factorial(n) : recursiveFactorial(n));
+    }
+  }
+
+  // n < 16, since the cost of the recursion grows exponentially
+  template<bool Table>
+  void binomial(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      auto n = static_cast<unsigned>(arguments[i % argumentCount] % 16);
+      auto k = static_cast<unsigned>((arguments[i % argumentCount] >> 32) % (n + 1));
+      bench::doNotOptimize(Table ? tables::binomial(n, k) : recursiveBinomial(n, k));
+    }
+  }
+
+  template<bool Table>
+  void crc32(std::uint64_t iterations) {
+    const auto* data = reinterpret_cast<const std::uint8_t*>(arguments.data());
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(Table ? tables::crc32({data, sizeof(arguments)}) : bitwiseCrc32(data, sizeof(arguments)));
+    }
+  }
+
+  // 0: loop, 1: table, 2: std::popcount
+  template<int Method>
+  void popcount(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t x = arguments[i % argumentCount];
+      if constexpr (Method == 0) {
+        bench::doNotOptimize(loopPopcount(x));
+      } else if constexpr (Method == 1) {
+        bench::doNotOptimize(tables::popcount(x));
+      } else {
+        bench::doNotOptimize(std::popcount(x));
+      }
+    }
+  }
+
+  template<bool Table>
+  void reverseBits(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::uint64_t x = arguments[i % argumentCount];
+      bench::doNotOptimize(Table ? tables::reverseBits(x) : loopReverseBits(x));
+    }
+  }
+
+  // A tag-heavy workload: a stream of events, each carrying one of 1000 tags which share long prefixes
+  struct Tags {
+    std::vector<std::string> strings;
+    std::vector<interning::Symbol> symbols;
+    interning::Interner interner;
+
+    Tags() {
+      for (std::size_t i = 0; i < 1000; ++i) {
+        strings.push_back("service.frontend.request." + std::to_string(i % 10) + ".latency.bucket_" + std::to_string(i));
+        symbols.push_back(interner.intern(strings.back()));
+      }
+    }
+
+    std::size_t event(std::uint64_t i) const {
+      return arguments[i % argumentCount] % strings.size();
+    }
+  };
+
+  const Tags& tags() {
+    static const Tags t;
+    return t;
+  }
+
+  struct TransparentHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+  };
+
+  void internExisting(std::uint64_t iterations) {
+    static Tags t;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(t.interner.intern(t.strings[t.event(i)]));
+    }
+  }
+
+  void unorderedMapFind(std::uint64_t iterations) {
+    const Tags& t = tags();
+    static const auto map = [&t] {
+      std::unordered_map<std::string, std::uint32_t, TransparentHash, std::equal_to<>> m;
+      for (std::size_t i = 0; i < t.strings.size(); ++i) {
+        m.emplace(t.strings[i], static_cast<std::uint32_t>(i));
+      }
+      return m;
+    }();
+
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(map.find(std::string_view(t.strings[t.event(i)]))->second);
+    }
+  }
+
+  // Whether two consecutive events carry the same tag
+  template<bool Symbols>
+  void equality(std::uint64_t iterations) {
+    const Tags& t = tags();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t a = t.event(i);
+      std::size_t b = t.event(i + 1);
+      if constexpr (Symbols) {
+        bench::doNotOptimize(t.symbols[a] == t.symbols[b]);
+      } else {
+        bench::doNotOptimize(t.strings[a] == t.strings[b]);
+      }
+    }
+  }
+
+  // Counts the events of each tag
+  void stringHistogram(std::uint64_t iterations) {
+    const Tags& t = tags();
+    std::unordered_map<std::string_view, std::uint64_t> counts;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      ++counts[t.strings[t.event(i)]];
+    }
+    bench::doNotOptimize(counts);
+  }
+
+  void symbolHistogram(std::uint64_t iterations) {
+    const Tags& t = tags();
+    std::vector<std::uint64_t> counts(t.interner.size());
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      ++counts[t.symbols[t.event(i)].id];
+    }
+    bench::doNotOptimize(counts);
+  }
+
+  // One counter per thread: packed counters share cache lines, padded counters don't
+  constexpr std::size_t maxThreads = 16;
+  std::atomic<std::uint64_t> packedCounters[maxThreads];
+  alignment::PerThread<std::atomic<std::uint64_t>> paddedCounters(maxThreads);
+
+  // Splits 'iterations' increments evenly across 'Threads' threads, each of which only increments its own counter. The threads never share any
+  // data, so they should scale perfectly; with packed counters, they still contend for the cache lines of the counters.
+  template<bool Padded, unsigned Threads>
+  void falseSharing(std::uint64_t iterations) {
+
+    static_assert(Threads <= maxThreads);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < Threads; ++t) {
+      threads.emplace_back([t, n = (iterations + Threads - 1) / Threads] {
+        std::atomic<std::uint64_t>& counter = Padded ? paddedCounters[t] : packedCounters[t];
+        for (std::uint64_t u = 0; u < n; ++u) {
+          counter.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    }
+
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+}
+
+BENCHMARK("specifiers/factorial/recursive", factorial<false>);
+BENCHMARK("specifiers/factorial/table", factorial<true>);
+BENCHMARK("specifiers/binomial/recursive", binomial<false>);
+BENCHMARK("specifiers/binomial/table", binomial<true>);
+BENCHMARK("specifiers/crc32/8KiB/bitwise", crc32<false>, 1, sizeof(arguments));
+BENCHMARK("specifiers/crc32/8KiB/table", crc32<true>, 1, sizeof(arguments));
+BENCHMARK("specifiers/popcount/loop", popcount<0>);
+BENCHMARK("specifiers/popcount/table", popcount<1>);
+BENCHMARK("specifiers/popcount/std", popcount<2>);
+BENCHMARK("specifiers/reverseBits/loop", reverseBits<false>);
+BENCHMARK("specifiers/reverseBits/table", reverseBits<true>);
+
+BENCHMARK("specifiers/interner/intern", internExisting);
+BENCHMARK("specifiers/interner/unorderedMapFind", unorderedMapFind);
+BENCHMARK("specifiers/interner/equality/strings", equality<false>);
+BENCHMARK("specifiers/interner/equality/symbols", equality<true>);
+BENCHMARK("specifiers/interner/histogram/strings", stringHistogram);
+BENCHMARK("specifiers/interner/histogram/symbols", symbolHistogram);
+
+BENCHMARK("specifiers/falseSharing/packed/1", falseSharing<false, 1>);
+BENCHMARK("specifiers/falseSharing/padded/1", falseSharing<true, 1>);
+BENCHMARK("specifiers/falseSharing/packed/2", falseSharing<false, 2>);
+BENCHMARK("specifiers/falseSharing/padded/2", falseSharing<true, 2>);
+BENCHMARK("specifiers/falseSharing/packed/4", falseSharing<false, 4>);
+BENCHMARK("specifiers/falseSharing/padded/4", falseSharing<true, 4>);
+BENCHMARK("specifiers/falseSharing/packed/8", falseSharing<false, 8>);
+BENCHMARK("specifiers/falseSharing/padded/8", falseSharing<true, 8>);
+BENCHMARK("specifiers/falseSharing/packed/16", falseSharing<false, 16>);
+BENCHMARK("specifiers/falseSharing/padded/16", falseSharing<true, 16>);
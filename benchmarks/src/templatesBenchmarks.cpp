@@ -0,0 +1,165 @@
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "classTemplates.h"
+#include "parameterPacks.h"
+#include "reductions.h"
+#include "soaVector.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  void classTemplates(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      classTemplateDemonstration();
+    }
+  }
+  
+  void memberFunctionTemplate(std::uint64_t iterations) {
+    unsigned int r = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      double d = static_cast<double>(i);
+      bench::doNotOptimize(d);
+      r += T_C(d).x;
+    }
+    bench::doNotOptimize(r);
+  }
+  
+  void foldExpression(std::uint64_t iterations) {
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      Demo<1, 2, 3, 4, 5, 6, 7, 8> d;
+      bench::doNotOptimize(d);
+    }
+  }
+  
+  // A 32-byte row: price, volume, timestamp, id, weight
+  using Aos = std::vector<std::tuple<double, double, std::int64_t, std::uint32_t, float>>;
+  using Soa = templates::SoAVector<double, double, std::int64_t, std::uint32_t, float>;
+  
+  constexpr std::size_t rows = 10'000'000;
+  
+  template<typename Table>
+  struct Dataset {
+    
+    Table table;
+    
+    Dataset() {
+      table.reserve(rows);
+      for (std::size_t i = 0; i < rows; ++i) {
+        table.push_back({double(i % 1000) * 0.25, double(i), std::int64_t(i) * 1000, std::uint32_t(i), 1.0f});
+      }
+    }
+    
+  };
+  
+  // Only one of the 10M-row datasets is kept in memory at a time
+  template<typename Table>
+  const Table& table() {
+    return bench::sharedFixture<Dataset<Table>>(0).table;
+  }
+  
+  // Sums the timestamp field of every row. Integer addition is associative, so the compiler is free to vectorize the sum, but even a single add per
+  // row (as GCC emits at -O2) is much faster than the memory it reads: the scans measure memory traffic. Only the 8-byte timestamp of each 32-byte
+  // row is used, so the row layout pulls 4 times as many cache lines through the memory hierarchy as the timestamp column does.
+  void aosScan(std::uint64_t iterations) {
+    const Aos& aos = table<Aos>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::int64_t sum = 0;
+      for (const auto& row : aos) {
+        sum += std::get<2>(row);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void soaColumnScan(std::uint64_t iterations) {
+    const Soa& soa = table<Soa>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::int64_t sum = 0;
+      for (std::int64_t timestamp : soa.column<2>()) {
+        sum += timestamp;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  // The same scan through row proxies, which the compiler reduces to the column scan
+  void soaRowScan(std::uint64_t iterations) {
+    const Soa& soa = table<Soa>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::int64_t sum = 0;
+      for (const auto& [price, volume, timestamp, id, weight] : soa) {
+        sum += timestamp;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  
+  template<std::size_t N>
+  const std::vector<double>& samples() {
+    static const std::vector<double> values = [] {
+      std::vector<double> v(N);
+      for (std::size_t i = 0; i < N; ++i) {
+        v[i] = double((i * 2654435761u) % 1000) * 0.5;
+      }
+      return v;
+    }();
+    return values;
+  }
+  
+  // A single sum is one chain of dependent additions unless it is split into lanes
+  template<std::size_t N, std::size_t Lanes>
+  void sumReduction(std::uint64_t iterations) {
+    const auto& values = samples<N>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(templates::reduce<Lanes>(values, templates::Sum{}));
+    }
+  }
+  
+  // Sum, min, max, count, mean, and variance, one pass per statistic
+  template<std::size_t N>
+  void separateReductions(std::uint64_t iterations) {
+    const auto& values = samples<N>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Sum{}));
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Min{}));
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Max{}));
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Count{}));
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Mean{}));
+      bench::doNotOptimize(templates::reduce<1>(values, templates::Variance{}));
+    }
+  }
+  
+  // The same statistics, in a single pass
+  template<std::size_t N, std::size_t Lanes>
+  void fusedReductions(std::uint64_t iterations) {
+    const auto& values = samples<N>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      bench::doNotOptimize(templates::reduce<Lanes>(values, templates::Sum{}, templates::Min{}, templates::Max{}, templates::Count{},
+                                                    templates::Mean{}, templates::Variance{}));
+    }
+  }
+  
+}
+
+BENCHMARK("templates/classTemplateDemonstration", classTemplates);
+BENCHMARK("templates/T_C/memberFunctionTemplate", memberFunctionTemplate);
+BENCHMARK("templates/Demo/foldExpression", foldExpression);
+
+BENCHMARK("templates/scan/aos/10M", aosScan, rows, rows * sizeof(std::int64_t));
+BENCHMARK("templates/scan/soa/column/10M", soaColumnScan, rows, rows * sizeof(std::int64_t));
+BENCHMARK("templates/scan/soa/rows/10M", soaRowScan, rows, rows * sizeof(std::int64_t));
+
+BENCHMARK("templates/reduce/sum/1lane/4K", sumReduction<4'096, 1>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/sum/4lanes/4K", sumReduction<4'096, 4>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/separate/4K", separateReductions<4'096>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/fused/1lane/4K", fusedReductions<4'096, 1>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/fused/4lanes/4K", fusedReductions<4'096, 4>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/fused/8lanes/4K", fusedReductions<4'096, 8>, 4'096, 4'096 * sizeof(double));
+BENCHMARK("templates/reduce/separate/10M", separateReductions<rows>, rows, rows * sizeof(double));
+BENCHMARK("templates/reduce/fused/1lane/10M", fusedReductions<rows, 1>, rows, rows * sizeof(double));
+BENCHMARK("templates/reduce/fused/4lanes/10M", fusedReductions<rows, 4>, rows, rows * sizeof(double));
+BENCHMARK("templates/reduce/fused/8lanes/10M", fusedReductions<rows, 8>, rows, rows * sizeof(double));
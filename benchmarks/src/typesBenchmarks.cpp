@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "enumReflection.h"
+#include "taggedUnion.h"
+#include "types.h"
+#include "unrolledList.h"
+
+#include "benchmarks.h"
+
+namespace {
+  
+  // Marks the values inserted by the insert/erase benchmarks, so that the erase pass can find them again
+  constexpr types::alias inserted = types::B;
+  
+  // Insert a value after every 'stride' values
+  constexpr std::size_t stride = 16;
+  
+  // A list of individually allocated 'Node' objects. Nodes are linked in a random order, which models the scattered layout that a long-lived list
+  // acquires on a real heap (nodes linked in allocation order would be laid out sequentially and hide the cost of pointer chasing).
+  struct NodeList {
+    
+    types::Node* head = nullptr;
+    
+    explicit NodeList(std::size_t n, bool shuffled = true) {
+      
+      std::vector<types::Node*> nodes(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        nodes[i] = new types::Node{nullptr, (i % 2) ? types::A : types::C};
+      }
+      
+      if (shuffled) {
+        std::shuffle(nodes.begin(), nodes.end(), std::mt19937_64(42));
+      }
+      
+      for (std::size_t i = n; i-- > 0;) {
+        nodes[i]->Node = head;
+        head = nodes[i];
+      }
+    }
+    
+    NodeList(const NodeList&) = delete;
+    NodeList& operator=(const NodeList&) = delete;
+    
+    ~NodeList() {
+      while (head) {
+        types::Node* next = head->next();
+        delete head;
+        head = next;
+      }
+    }
+    
+  };
+  
+  struct BlockList {
+    
+    types::UnrolledList<> list;
+    
+    explicit BlockList(std::size_t n) {
+      list.reserve(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        list.push_back((i % 2) ? types::A : types::C);
+      }
+    }
+    
+  };
+  
+  // Only one data set is alive at a time, so that the data sets of the largest benchmarks never coexist in memory
+  template<typename F, std::size_t N>
+  F& fixture() {
+    return bench::sharedFixture<F>(N, N);
+  }
+  
+  template<std::size_t N>
+  void nodeTraverse(std::uint64_t iterations) {
+    types::Node* head = fixture<NodeList, N>().head;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t sum = 0;
+      for (types::Node* n = head; n; n = n->next()) {
+        sum += n->value();
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t N>
+  void unrolledTraverse(std::uint64_t iterations) {
+    const types::UnrolledList<>& list = fixture<BlockList, N>().list;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t sum = 0;
+      for (types::alias v : list) {
+        sum += v;
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t N>
+  void nodeBuild(std::uint64_t iterations) {
+    bench::releaseSharedFixture();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      NodeList list(N, false);
+      bench::doNotOptimize(list.head);
+    }
+  }
+  
+  template<std::size_t N>
+  void unrolledBuild(std::uint64_t iterations) {
+    bench::releaseSharedFixture();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      types::UnrolledList<> list;
+      for (std::size_t j = 0; j < N; ++j) {
+        list.push_back(types::A);
+      }
+      bench::doNotOptimize(list);
+    }
+  }
+  
+  // One pass inserting a value after every 'stride' values, followed by one pass erasing them again
+  template<std::size_t N>
+  void nodeInsertErase(std::uint64_t iterations) {
+    types::Node* head = fixture<NodeList, N>().head;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t k = 0;
+      for (types::Node* n = head; n; n = n->next()) {
+        if (++k % stride == 0) {
+          n->Node = new types::Node{n->next(), inserted};
+          n = n->next();
+        }
+      }
+      
+      for (types::Node* n = head; n; n = n->next()) {
+        while (n->next() && n->next()->value() == inserted) {
+          types::Node* erased = n->next();
+          n->Node = erased->next();
+          delete erased;
+        }
+      }
+    }
+  }
+  
+  template<std::size_t N>
+  void unrolledInsertErase(std::uint64_t iterations) {
+    types::UnrolledList<>& list = fixture<BlockList, N>().list;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t k = 0;
+      for (auto c = list.begin(); c; c = c.next()) {
+        if (++k % stride == 0) {
+          c = list.insert(c.next(), inserted);
+        }
+      }
+      
+      for (auto c = list.begin(); c;) {
+        c = (c.value() == inserted) ? list.erase(c) : c.next();
+      }
+    }
+  }
+  
+  // Heterogeneous elements: the largest alternative takes 9 bytes, so the tag of a TaggedUnion fits into the padding (16 bytes per element), while
+  // the index of a std::variant doesn't (24 bytes per element)
+  using Name = std::array<char, 9>;
+  using Variant = std::variant<int, double, Name>;
+  using Tagged = types::TaggedUnion<int, double, Name>;
+  
+  static_assert(sizeof(Tagged) == 16);
+  static_assert(sizeof(Variant) == 24);
+  
+  // The alternatives are mixed in a random order, so that the branch predictor can't learn which one comes next
+  template<typename U>
+  struct UnionArray {
+    
+    std::vector<U> values;
+    
+    explicit UnionArray(std::size_t n) {
+      
+      std::mt19937_64 random(42);
+      values.reserve(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        switch (random() % 3) {
+          case 0: values.emplace_back(static_cast<int>(i)); break;
+          case 1: values.emplace_back(static_cast<double>(i) / 2); break;
+          default: values.emplace_back(Name{static_cast<char>(i)}); break;
+        }
+      }
+    }
+    
+  };
+  
+  struct Weight {
+    double operator()(int x) const { return x; }
+    double operator()(double x) const { return x; }
+    double operator()(const Name& x) const { return x[0]; }
+  };
+  
+  template<std::size_t N>
+  void variantVisit(std::uint64_t iterations) {
+    const std::vector<Variant>& values = fixture<UnionArray<Variant>, N>().values;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      double sum = 0;
+      for (const Variant& v : values) {
+        sum += std::visit(Weight{}, v);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t N>
+  void taggedVisit(std::uint64_t iterations) {
+    const std::vector<Tagged>& values = fixture<UnionArray<Tagged>, N>().values;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      double sum = 0;
+      for (const Tagged& v : values) {
+        sum += v.visit(Weight{});
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  template<std::size_t N>
+  void variantCopy(std::uint64_t iterations) {
+    const std::vector<Variant>& values = fixture<UnionArray<Variant>, N>().values;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::vector<Variant> copy(values);
+      bench::doNotOptimize(copy);
+    }
+  }
+  
+  template<std::size_t N>
+  void taggedCopy(std::uint64_t iterations) {
+    const std::vector<Tagged>& values = fixture<UnionArray<Tagged>, N>().values;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::vector<Tagged> copy(values);
+      bench::doNotOptimize(copy);
+    }
+  }
+  
+  enum class Method { GET, HEAD, POST, PUT, DELETE, CONNECT, OPTIONS, TRACE, PATCH };
+  
+  static_assert(enums::count<Method> == 9 && enums::contiguous<Method>);
+  
+  // The usual hand-written alternative to reflection: maps in both directions, filled at startup
+  const std::unordered_map<Method, std::string_view>& methodNames() {
+    static const std::unordered_map<Method, std::string_view> map = [] {
+      std::unordered_map<Method, std::string_view> m;
+      for (std::size_t i = 0; i < enums::count<Method>; ++i) {
+        m.emplace(enums::values<Method>[i], enums::names<Method>[i]);
+      }
+      return m;
+    }();
+    return map;
+  }
+  
+  const std::unordered_map<std::string_view, Method>& methodValues() {
+    static const std::unordered_map<std::string_view, Method> map = [] {
+      std::unordered_map<std::string_view, Method> m;
+      for (std::size_t i = 0; i < enums::count<Method>; ++i) {
+        m.emplace(enums::names<Method>[i], enums::values<Method>[i]);
+      }
+      return m;
+    }();
+    return map;
+  }
+  
+  // 1K methods in a random order, and their names
+  constexpr std::size_t methodCount = 1'000;
+  
+  const std::vector<Method>& randomMethods() {
+    static const std::vector<Method> methods = [] {
+      std::mt19937_64 random(42);
+      std::vector<Method> m(methodCount);
+      for (Method& method : m) {
+        method = enums::values<Method>[random() % enums::count<Method>];
+      }
+      return m;
+    }();
+    return methods;
+  }
+  
+  const std::vector<std::string_view>& randomMethodNames() {
+    static const std::vector<std::string_view> names = [] {
+      std::vector<std::string_view> n;
+      for (Method m : randomMethods()) {
+        n.push_back(enums::name(m));
+      }
+      return n;
+    }();
+    return names;
+  }
+  
+  void mapToName(std::uint64_t iterations) {
+    const auto& map = methodNames();
+    const std::vector<Method>& methods = randomMethods();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t length = 0;
+      for (Method m : methods) {
+        length += map.find(m)->second.size();
+      }
+      bench::doNotOptimize(length);
+    }
+  }
+  
+  void reflectedToName(std::uint64_t iterations) {
+    const std::vector<Method>& methods = randomMethods();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::size_t length = 0;
+      for (Method m : methods) {
+        length += enums::name(m).size();
+      }
+      bench::doNotOptimize(length);
+    }
+  }
+  
+  void mapFromName(std::uint64_t iterations) {
+    const auto& map = methodValues();
+    const std::vector<std::string_view>& names = randomMethodNames();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      int sum = 0;
+      for (std::string_view n : names) {
+        sum += static_cast<int>(map.find(n)->second);
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  void reflectedFromName(std::uint64_t iterations) {
+    const std::vector<std::string_view>& names = randomMethodNames();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      int sum = 0;
+      for (std::string_view n : names) {
+        sum += static_cast<int>(*enums::fromName<Method>(n));
+      }
+      bench::doNotOptimize(sum);
+    }
+  }
+  
+  // Counts the occurrences of each method
+  void mapCount(std::uint64_t iterations) {
+    const std::vector<Method>& methods = randomMethods();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      std::unordered_map<Method, int> counts;
+      for (Method m : methods) {
+        ++counts[m];
+      }
+      bench::doNotOptimize(counts);
+    }
+  }
+  
+  void enumMapCount(std::uint64_t iterations) {
+    const std::vector<Method>& methods = randomMethods();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+      enums::EnumMap<Method, int> counts;
+      for (Method m : methods) {
+        ++counts[m];
+      }
+      bench::doNotOptimize(counts);
+    }
+  }
+  
+}
+
+BENCHMARK("types/list/node/traverse/1K", nodeTraverse<1'000>, 1'000);
+BENCHMARK("types/list/unrolled/traverse/1K", unrolledTraverse<1'000>, 1'000);
+BENCHMARK("types/list/node/build/1K", nodeBuild<1'000>, 1'000);
+BENCHMARK("types/list/unrolled/build/1K", unrolledBuild<1'000>, 1'000);
+BENCHMARK("types/list/node/insertErase/1K", nodeInsertErase<1'000>, 1'000);
+BENCHMARK("types/list/unrolled/insertErase/1K", unrolledInsertErase<1'000>, 1'000);
+
+BENCHMARK("types/list/node/traverse/1M", nodeTraverse<1'000'000>, 1'000'000);
+BENCHMARK("types/list/unrolled/traverse/1M", unrolledTraverse<1'000'000>, 1'000'000);
+BENCHMARK("types/list/node/build/1M", nodeBuild<1'000'000>, 1'000'000);
+BENCHMARK("types/list/unrolled/build/1M", unrolledBuild<1'000'000>, 1'000'000);
+BENCHMARK("types/list/node/insertErase/1M", nodeInsertErase<1'000'000>, 1'000'000);
+BENCHMARK("types/list/unrolled/insertErase/1M", unrolledInsertErase<1'000'000>, 1'000'000);
+
+BENCHMARK("types/list/node/traverse/100M", nodeTraverse<100'000'000>, 100'000'000);
+BENCHMARK("types/list/unrolled/traverse/100M", unrolledTraverse<100'000'000>, 100'000'000);
+BENCHMARK("types/list/node/build/100M", nodeBuild<100'000'000>, 100'000'000);
+BENCHMARK("types/list/unrolled/build/100M", unrolledBuild<100'000'000>, 100'000'000);
+BENCHMARK("types/list/node/insertErase/100M", nodeInsertErase<100'000'000>, 100'000'000);
+BENCHMARK("types/list/unrolled/insertErase/100M", unrolledInsertErase<100'000'000>, 100'000'000);
+
+BENCHMARK("types/union/variant/visit/1K", variantVisit<1'000>, 1'000, 1'000 * sizeof(Variant));
+BENCHMARK("types/union/tagged/visit/1K", taggedVisit<1'000>, 1'000, 1'000 * sizeof(Tagged));
+BENCHMARK("types/union/variant/visit/10M", variantVisit<10'000'000>, 10'000'000, 10'000'000 * sizeof(Variant));
+BENCHMARK("types/union/tagged/visit/10M", taggedVisit<10'000'000>, 10'000'000, 10'000'000 * sizeof(Tagged));
+BENCHMARK("types/union/variant/copy/10M", variantCopy<10'000'000>, 10'000'000, 10'000'000 * sizeof(Variant));
+BENCHMARK("types/union/tagged/copy/10M", taggedCopy<10'000'000>, 10'000'000, 10'000'000 * sizeof(Tagged));
+
+BENCHMARK("types/enum/toName/unorderedMap", mapToName, methodCount);
+BENCHMARK("types/enum/toName/reflected", reflectedToName, methodCount);
+BENCHMARK("types/enum/fromName/unorderedMap", mapFromName, methodCount);
+BENCHMARK("types/enum/fromName/reflected", reflectedFromName, methodCount);
+BENCHMARK("types/enum/count/unorderedMap", mapCount, methodCount);
+BENCHMARK("types/enum/count/enumMap", enumMapCount, methodCount);
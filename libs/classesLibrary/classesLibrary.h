@@ -2,5 +2,7 @@
 #define CLASSESLIBRARY_H
 
 #include "class.h"
+#include "packedIntArray.h"
+#include "polyCollection.h"
 
 #endif // CLASSESLIBRARY_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef CPP_CLASS_H
 #define CPP_CLASS_H
 
+#include <type_traits>
+
 /**
  * This file demonstrates the many concepts of C++ classes.
  */
@@ -270,12 +272,11 @@ struct ClassN {
   
   // Move constructor (note that it steals the resources of the argument)
   ClassN(ClassN&& n): x(n.x) {
-    y = new int;
     y = n.y;
     n.y = 0;
   }
   
-  // Copy constructor
+  // Copy assignment operator
   ClassN& operator=(ClassN& n) {
     x = n.x;
     *y = *(n.y);
@@ -283,11 +284,15 @@ struct ClassN {
     return *this;
   }
   
-  // Move constructor
+  // Move assignment operator (note that the resources of the assigned-to object must be released before stealing those of the argument, unless the
+  // argument is the object itself, e.g. 'a = std::move(a)', which would otherwise release the resources it is about to steal)
   ClassN& operator=(ClassN&& n) {
-    x = n.x;
-    y = n.y;
-    n.y = 0;
+    if (this != &n) {
+      x = n.x;
+      delete y;
+      y = n.y;
+      n.y = 0;
+    }
     
     return *this;
   }
@@ -301,4 +306,75 @@ protected:
 
 };
 
+/**
+ * This class has the same interface as ClassN, but holds 'y' by value instead of on the heap. Construction never allocates, and since no member
+ * manages a resource, each of the five special member functions can be defaulted (see the Rule of Zero/Rule of Five in the design library). They are
+ * still declared explicitly to document the intended semantics:
+ * - Copies take 'const' references, so that temporaries and 'const' objects can be copied
+ * - Moves are 'noexcept', so that containers such as 'std::vector' move elements instead of copying them when they reallocate
+ * - The destructor is public and non-virtual, so that the class is trivially copyable and containers may relocate elements with 'memcpy'
+ */
+struct ClassO {
+  
+  int x;
+  int y;
+  
+  ClassO(): x(0), y(0) {}
+  
+  ClassO(int i, int j): x(i), y(j) {}
+  
+  explicit ClassO(int i): ClassO(i, i) {}
+  
+  ClassO(const ClassO& n) = default;
+  
+  ClassO(ClassO&& n) noexcept = default;
+  
+  ClassO& operator=(const ClassO& n) = default;
+  
+  ClassO& operator=(ClassO&& n) noexcept = default;
+  
+  ~ClassO() = default;
+  
+};
+
+static_assert(std::is_nothrow_move_constructible_v<ClassO> && std::is_nothrow_move_assignable_v<ClassO>);
+static_assert(std::is_trivially_copyable_v<ClassO>);
+
+/**
+ * These classes demonstrate static polymorphism with the "curiously recurring template pattern" (CRTP). They compute the same sums as ClassD and
+ * ClassE, but the base class is a template which takes the derived class as an argument: ClassP::sum casts 'this' to the derived class and calls its
+ * 'sumImpl' directly, so the call is resolved at compile time (and can be inlined). There is no virtual function and no vtable pointer, but also no
+ * common base class: ClassP<ClassQ> and ClassP<ClassR> are unrelated types, so a collection of both holds them in a 'std::variant' or in a
+ * 'PolyCollection' (see "polyCollection.h") instead of through base pointers.
+ */
+template<typename Derived>
+struct ClassP {
+  
+  int sum(int i) {
+    return static_cast<Derived*>(this)->sumImpl(i);
+  }
+  
+};
+
+// Same sum as ClassD
+struct ClassQ : ClassP<ClassQ> {
+  
+  int y = 2;
+  int z = 3;
+  
+  int sumImpl(int i) {
+    return i + z + y;
+  }
+  
+};
+
+// Same sum as ClassE
+struct ClassR : ClassP<ClassR> {
+  
+  int sumImpl(int i) {
+    return i;
+  }
+  
+};
+
 #endif // CPP_CLASS_H
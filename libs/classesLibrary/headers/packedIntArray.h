@@ -0,0 +1,447 @@
+#ifndef CPP_PACKEDINTARRAY_H
+#define CPP_PACKEDINTARRAY_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bulkOperators.h"
+
+namespace classes {
+
+  namespace detail {
+
+    // Serializes compare-and-set operations on elements which straddle two words; see 'PackedIntArray::compareAndSet'
+    inline std::mutex straddleLocks[64];
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    // On x86, elements of up to 8 bits are converted by SIMD kernels, in groups of 8: 8 elements of 'Bits' bits take exactly 'Bits' bytes, so every
+    // group starts on a byte and fits into one (unaligned, little-endian) 64-bit word. Unpacking broadcasts the word of a group into 8 lanes, and
+    // shifts each lane by the position of its element; packing does the reverse, and merges the lanes with a tree of ORs.
+
+    typedef std::uint64_t Lanes __attribute__((vector_size(64)));
+    typedef std::int64_t SignedLanes __attribute__((vector_size(64)));
+
+    template<unsigned Bits>
+    constexpr Lanes groupShifts = {0, Bits, 2 * Bits, 3 * Bits, 4 * Bits, 5 * Bits, 6 * Bits, 7 * Bits};
+
+    template<unsigned Bits, bool Signed, typename T>
+    [[gnu::always_inline]] inline void unpackGroups(const unsigned char* bytes, T* out, std::size_t groups) {
+
+      typedef T Values __attribute__((vector_size(8 * sizeof(T))));
+
+      for (std::size_t g = 0; g < groups; ++g) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + g * Bits, sizeof(word));
+
+        Lanes lanes = ((Lanes{} + word) >> groupShifts<Bits>) & ((std::uint64_t(1) << Bits) - 1);
+        Values values;
+        if constexpr (Signed) {
+          values = __builtin_convertvector(((SignedLanes) (lanes << (64 - Bits))) >> (64 - Bits), Values);
+        } else {
+          values = __builtin_convertvector(lanes, Values);
+        }
+        std::memcpy(out + 8 * g, &values, sizeof(values));
+      }
+    }
+
+    template<unsigned Bits, typename T>
+    [[gnu::always_inline]] inline void packGroups(const T* in, unsigned char* bytes, std::size_t groups) {
+
+      typedef T Values __attribute__((vector_size(8 * sizeof(T))));
+
+      for (std::size_t g = 0; g < groups; ++g) {
+        Values values;
+        std::memcpy(&values, in + 8 * g, sizeof(values));
+
+        Lanes lanes = (__builtin_convertvector(values, Lanes) & ((std::uint64_t(1) << Bits) - 1)) << groupShifts<Bits>;
+        lanes |= __builtin_shuffle(lanes, Lanes{4, 5, 6, 7, 0, 1, 2, 3});
+        lanes |= __builtin_shuffle(lanes, Lanes{2, 3, 0, 1, 6, 7, 4, 5});
+        lanes |= __builtin_shuffle(lanes, Lanes{1, 0, 3, 2, 5, 4, 7, 6});
+
+        std::uint64_t word = lanes[0];
+        std::memcpy(bytes + g * Bits, &word, Bits);
+      }
+    }
+
+    // The lanes of a group take one AVX-512 register, or two AVX2 registers; there is no SSE2 kernel, since SSE2 can't shift each lane by a
+    // different amount
+
+    template<unsigned Bits, bool Signed, typename T>
+    [[gnu::target("avx2")]] void unpackGroupsAvx2(const unsigned char* bytes, T* out, std::size_t groups) {
+      unpackGroups<Bits, Signed>(bytes, out, groups);
+    }
+
+    template<unsigned Bits, bool Signed, typename T>
+    [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] void unpackGroupsAvx512(const unsigned char* bytes, T* out, std::size_t groups) {
+      unpackGroups<Bits, Signed>(bytes, out, groups);
+    }
+
+    template<unsigned Bits, typename T>
+    [[gnu::target("avx2")]] void packGroupsAvx2(const T* in, unsigned char* bytes, std::size_t groups) {
+      packGroups<Bits>(in, bytes, groups);
+    }
+
+    template<unsigned Bits, typename T>
+    [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]] void packGroupsAvx512(const T* in, unsigned char* bytes, std::size_t groups) {
+      packGroups<Bits>(in, bytes, groups);
+    }
+
+#endif
+
+  }
+
+  /**
+   * The bit fields of 'ClassA' generalized to an array: every element takes exactly 'Bits' bits (1 to 63), and consecutive elements are stored back
+   * to back across 64-bit words, so an element may straddle two words. Unlike bit fields, no bits are left unused: one million 3-bit values take
+   * 375 KB, where an array of 'unsigned char' would take 1 MB (and of 'int', 4 MB). Values are unsigned, or two's complement if 'Signed' is true (a
+   * 4-bit signed element, like 'ClassA::b', holds [-8 .. 7]); storing a value which doesn't fit keeps only its lowest 'Bits' bits.
+   *
+   * Elements are accessed with 'get' and 'set' (or through a proxy returned by 'operator[]', since, like a bit field, an element has no address).
+   * Every access takes a shift and a mask; to convert many elements at once, 'unpack' and 'pack' convert between the packed array and a plain array of
+   * integers. They work in blocks of 64 elements, which always take exactly 'Bits' whole words, so the position of each element within a block is a
+   * compile-time constant: each block is a fixed sequence of shifts and masks without branches. Elements of up to 8 bits are converted with AVX2 or
+   * AVX-512 where available (see 'bulk::activeIsa').
+   *
+   * 'get' and 'set' are not thread-safe, like accesses to plain integers. 'load' and 'compareAndSet' are: concurrent calls on any elements
+   * (including elements which share a word) are atomic, as long as no thread calls 'set' (or resizes the array) at the same time.
+   */
+  template<unsigned Bits, bool Signed = false>
+  class PackedIntArray {
+
+    static_assert(Bits >= 1 && Bits <= 63, "Elements take between 1 and 63 bits");
+
+  public:
+
+    using value_type = std::conditional_t<Signed, std::int64_t, std::uint64_t>;
+
+    static constexpr value_type min = Signed ? -(value_type(1) << (Bits - 1)) : 0;
+    static constexpr value_type max = Signed ? (value_type(1) << (Bits - 1)) - 1 : (value_type(1) << Bits) - 1;
+
+    // The number of elements in a block, and the number of words which it takes
+    static constexpr std::size_t blockSize = 64;
+    static constexpr std::size_t blockWords = Bits;
+
+  private:
+
+    static constexpr std::uint64_t mask = (std::uint64_t(1) << Bits) - 1;
+
+    // One more word than necessary, so that the second word of an element is always readable
+    std::vector<std::uint64_t> words = std::vector<std::uint64_t>(1);
+    std::size_t count = 0;
+
+    static std::size_t wordsFor(std::size_t size) {
+      return (size * Bits + 63) / 64 + 1;
+    }
+
+    static value_type decode(std::uint64_t bits) {
+      if constexpr (Signed) {
+        return static_cast<std::int64_t>(bits << (64 - Bits)) >> (64 - Bits);
+      } else {
+        return bits;
+      }
+    }
+
+    static std::uint64_t encode(value_type value) {
+      return static_cast<std::uint64_t>(value) & mask;
+    }
+
+    // Reads the element at bit 'bit' of 'w'. The second word is shifted in two steps so that the shift is never 64 (which is undefined); if the
+    // element doesn't straddle, its bits in the second word are 0 after masking.
+    static std::uint64_t extract(const std::uint64_t* w, std::size_t bit) {
+      std::size_t word = bit / 64;
+      std::size_t shift = bit % 64;
+      return ((w[word] >> shift) | ((w[word + 1] << 1) << (63 - shift))) & mask;
+    }
+
+    static void insert(std::uint64_t* w, std::size_t bit, std::uint64_t bits) {
+      std::size_t word = bit / 64;
+      std::size_t shift = bit % 64;
+      w[word] = (w[word] & ~(mask << shift)) | (bits << shift);
+      w[word + 1] = (w[word + 1] & ~((mask >> 1) >> (63 - shift))) | ((bits >> 1) >> (63 - shift));
+    }
+
+    // The element 'J' of the block starting at 'w', with its position known at compile time
+    template<std::size_t J>
+    static std::uint64_t extractFromBlock(const std::uint64_t* w) {
+
+      constexpr std::size_t word = J * Bits / 64;
+      constexpr std::size_t shift = J * Bits % 64;
+
+      if constexpr (shift + Bits > 64) {
+        return ((w[word] >> shift) | (w[word + 1] << (64 - shift))) & mask;
+      } else {
+        return (w[word] >> shift) & mask;
+      }
+    }
+
+    template<typename T, std::size_t ... J>
+    static void unpackBlock(const std::uint64_t* w, T* out, std::index_sequence<J...>) {
+      ((out[J] = static_cast<T>(decode(extractFromBlock<J>(w)))), ...);
+    }
+
+    // The word 'W' of a block, assembled from every element which has bits in it
+    template<std::size_t W, typename T, std::size_t ... J>
+    static std::uint64_t packWord(const T* in, std::index_sequence<J...>) {
+
+      auto part = [in]<std::size_t I>(std::integral_constant<std::size_t, I>) -> std::uint64_t {
+        constexpr std::size_t first = I * Bits;
+        constexpr std::size_t last = first + Bits;
+        if constexpr (first / 64 == W) {
+          return encode(static_cast<value_type>(in[I])) << (first % 64);
+        } else if constexpr (first / 64 + 1 == W && last > W * 64) {
+          return encode(static_cast<value_type>(in[I])) >> (64 - first % 64);
+        } else {
+          return 0;
+        }
+      };
+
+      return (part(std::integral_constant<std::size_t, J>{}) | ...);
+    }
+
+    template<typename T, std::size_t ... W>
+    static void packBlock(const T* in, std::uint64_t* w, std::index_sequence<W...>) {
+      ((w[W] = packWord<W>(in, std::make_index_sequence<blockSize>{})), ...);
+    }
+
+    template<typename T>
+    static void unpackBlocks(const std::uint64_t* w, T* out, std::size_t blocks) {
+
+#if defined(__x86_64__) || defined(__i386__)
+      if constexpr (Bits <= 8) {
+        auto* bytes = reinterpret_cast<const unsigned char*>(w);
+        switch (bulk::activeIsa()) {
+          case bulk::Isa::AVX512:
+            detail::unpackGroupsAvx512<Bits, Signed>(bytes, out, blocks * blockSize / 8);
+            return;
+          case bulk::Isa::AVX2:
+            detail::unpackGroupsAvx2<Bits, Signed>(bytes, out, blocks * blockSize / 8);
+            return;
+          default:
+            break;
+        }
+      }
+#endif
+
+      for (std::size_t b = 0; b < blocks; ++b) {
+        unpackBlock(w + b * blockWords, out + b * blockSize, std::make_index_sequence<blockSize>{});
+      }
+    }
+
+    template<typename T>
+    static void packBlocks(const T* in, std::uint64_t* w, std::size_t blocks) {
+
+#if defined(__x86_64__) || defined(__i386__)
+      if constexpr (Bits <= 8) {
+        auto* bytes = reinterpret_cast<unsigned char*>(w);
+        switch (bulk::activeIsa()) {
+          case bulk::Isa::AVX512:
+            detail::packGroupsAvx512<Bits>(in, bytes, blocks * blockSize / 8);
+            return;
+          case bulk::Isa::AVX2:
+            detail::packGroupsAvx2<Bits>(in, bytes, blocks * blockSize / 8);
+            return;
+          default:
+            break;
+        }
+      }
+#endif
+
+      for (std::size_t b = 0; b < blocks; ++b) {
+        packBlock(in + b * blockSize, w + b * blockWords, std::make_index_sequence<blockWords>{});
+      }
+    }
+
+  public:
+
+    // Every element is 0
+    PackedIntArray() = default;
+    explicit PackedIntArray(std::size_t size): words(wordsFor(size)), count(size) {}
+
+    std::size_t size() const {
+      return count;
+    }
+
+    // The memory taken by the elements
+    std::size_t bytes() const {
+      return words.size() * sizeof(std::uint64_t);
+    }
+
+    // New elements are 0
+    void resize(std::size_t size) {
+
+      if (size < count) {
+        // Clears the bits of the removed elements, so that growing again yields zeros
+        for (std::size_t i = size; i < count; ++i) {
+          insert(words.data(), i * Bits, 0);
+        }
+      }
+
+      words.resize(wordsFor(size));
+      count = size;
+    }
+
+    void reserve(std::size_t size) {
+      words.reserve(wordsFor(size));
+    }
+
+    void push_back(value_type value) {
+      words.resize(wordsFor(count + 1));
+      insert(words.data(), count * Bits, encode(value));
+      ++count;
+    }
+
+    void clear() {
+      words.assign(1, 0);
+      count = 0;
+    }
+
+    value_type get(std::size_t i) const {
+      return decode(extract(words.data(), i * Bits));
+    }
+
+    void set(std::size_t i, value_type value) {
+      insert(words.data(), i * Bits, encode(value));
+    }
+
+    // An element can't be referenced directly, so 'operator[]' returns a proxy which reads and writes it
+    class Reference {
+
+      PackedIntArray& array;
+      std::size_t i;
+
+    public:
+
+      Reference(PackedIntArray& array, std::size_t i): array(array), i(i) {}
+
+      operator value_type() const { return array.get(i); }
+
+      Reference& operator=(value_type value) { array.set(i, value); return *this; }
+      Reference& operator=(const Reference& other) { return *this = value_type(other); }
+    };
+
+    Reference operator[](std::size_t i) {
+      return {*this, i};
+    }
+
+    value_type operator[](std::size_t i) const {
+      return get(i);
+    }
+
+    // Atomically reads element 'i', which may be concurrently updated by 'compareAndSet' (an element which straddles two words takes its lock)
+    value_type load(std::size_t i) const {
+
+      const std::size_t word = i * Bits / 64;
+      const std::size_t shift = i * Bits % 64;
+      auto ref = [this](std::size_t w) { return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(words[w])); };
+
+      if (shift + Bits <= 64) {
+        return decode((ref(word).load(std::memory_order_acquire) >> shift) & mask);
+      }
+
+      std::lock_guard<std::mutex> guard(detail::straddleLocks[i % std::size(detail::straddleLocks)]);
+      std::uint64_t low = ref(word).load(std::memory_order_acquire) >> shift;
+      std::uint64_t high = ref(word + 1).load(std::memory_order_acquire) << (64 - shift);
+      return decode((low | high) & mask);
+    }
+
+    /**
+     * Atomically replaces element 'i' with 'desired' if it's equal to 'expected', and returns whether it did.
+     *
+     * An element within a single word is updated with a compare-and-swap of that word, which fails (and is retried) if any element of the word
+     * changed, not only element 'i'. An element which straddles two words can't be updated with a single compare-and-swap, so its update takes a lock
+     * (one of a fixed set, chosen by index); each word is still updated with a compare-and-swap, so that concurrent updates of the other elements of
+     * those words aren't lost.
+     */
+    bool compareAndSet(std::size_t i, value_type expected, value_type desired) {
+
+      const std::size_t word = i * Bits / 64;
+      const std::size_t shift = i * Bits % 64;
+      const std::uint64_t from = encode(expected);
+      const std::uint64_t to = encode(desired);
+
+      auto update = [&](std::size_t w, std::uint64_t fieldMask, std::uint64_t fieldFrom, std::uint64_t fieldTo) {
+        std::atomic_ref<std::uint64_t> ref(words[w]);
+        std::uint64_t current = ref.load(std::memory_order_relaxed);
+        do {
+          if ((current & fieldMask) != fieldFrom) {
+            return false;
+          }
+        } while (!ref.compare_exchange_weak(current, (current & ~fieldMask) | fieldTo, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return true;
+      };
+
+      if (shift + Bits <= 64) {
+        return update(word, mask << shift, from << shift, to << shift);
+      }
+
+      std::lock_guard<std::mutex> guard(detail::straddleLocks[i % std::size(detail::straddleLocks)]);
+
+      // Only the holder of the lock writes the bits of element 'i', so reading both halves first gives a consistent value
+      std::uint64_t low = std::atomic_ref<std::uint64_t>(words[word]).load(std::memory_order_acquire) >> shift;
+      std::uint64_t high = std::atomic_ref<std::uint64_t>(words[word + 1]).load(std::memory_order_acquire) << (64 - shift);
+      if (((low | high) & mask) != from) {
+        return false;
+      }
+
+      update(word, mask << shift, from << shift, to << shift);
+      update(word + 1, mask >> (64 - shift), from >> (64 - shift), to >> (64 - shift));
+      return true;
+    }
+
+    // Converts 'out.size()' elements, starting at element 'first', into plain integers
+    template<std::integral T>
+    void unpack(std::size_t first, std::span<T> out) const {
+
+      static_assert(8 * sizeof(T) >= Bits, "The elements don't fit into the output type");
+
+      // Elements before the first whole block
+      const std::size_t head = std::min(out.size(), (blockSize - first % blockSize) % blockSize);
+      std::size_t i = 0;
+      for (; i < head; ++i) {
+        out[i] = static_cast<T>(get(first + i));
+      }
+      const std::size_t blocks = (out.size() - i) / blockSize;
+      unpackBlocks(words.data() + (first + i) / blockSize * blockWords, out.data() + i, blocks);
+      i += blocks * blockSize;
+      for (; i < out.size(); ++i) {
+        out[i] = static_cast<T>(get(first + i));
+      }
+    }
+
+    // Replaces 'in.size()' elements, starting at element 'first', with plain integers; the array must already have these elements
+    template<std::integral T>
+    void pack(std::size_t first, std::span<const T> in) {
+
+      const std::size_t head = std::min(in.size(), (blockSize - first % blockSize) % blockSize);
+      std::size_t i = 0;
+      for (; i < head; ++i) {
+        set(first + i, static_cast<value_type>(in[i]));
+      }
+      const std::size_t blocks = (in.size() - i) / blockSize;
+      packBlocks(in.data() + i, words.data() + (first + i) / blockSize * blockWords, blocks);
+      i += blocks * blockSize;
+      for (; i < in.size(); ++i) {
+        set(first + i, static_cast<value_type>(in[i]));
+      }
+    }
+
+    template<std::integral T>
+    void pack(std::size_t first, std::span<T> in) {
+      pack(first, std::span<const T>(in));
+    }
+
+  };
+
+}
+
+#endif // CPP_PACKEDINTARRAY_H
@@ -0,0 +1,144 @@
+#ifndef CPP_POLYCOLLECTION_H
+#define CPP_POLYCOLLECTION_H
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace classes {
+
+  /**
+   * A collection of objects of several related types (e.g. ClassD and ClassE), which groups the objects by type instead of holding them through
+   * base pointers: each type in 'Types' has its own contiguous segment (a 'std::vector'), and objects are stored by value in the segment of their
+   * type.
+   *
+   * Calling a virtual function through a 'std::vector<Base*>' costs, for every object, a load of its vtable pointer, an indirect call which the
+   * branch predictor must guess when the types are mixed, and often a cache miss, since the objects are allocated separately. 'forEach' instead
+   * visits one segment at a time, with the type of the objects known at compile time: calls can be resolved statically and inlined, and the objects
+   * of a segment are contiguous. A virtual function is still dispatched virtually unless the call is qualified (or the function is 'final'):
+   *
+   *   classes::PolyCollection<ClassD, Derived> objects;
+   *   objects.forEach([&](auto& object) {
+   *     using T = std::remove_reference_t<decltype(object)>;
+   *     total += object.T::sum(1);   // Calls the 'sum' of the exact type of 'object', without the vtable
+   *   });
+   *
+   * Objects are visited in order of type and then of insertion, not in the order in which they were inserted overall. Inserting into a segment may
+   * move the objects of that segment, like 'std::vector'.
+   */
+  template<typename ... Types>
+  class PolyCollection {
+
+    static_assert(sizeof...(Types) > 0, "A PolyCollection needs at least one type");
+
+    std::tuple<std::vector<Types>...> segments;
+
+    template<typename T>
+    static constexpr bool isMember = (std::is_same_v<T, Types> || ...);
+
+    // A reference to a polymorphic base may refer to an object of any of the types derived from it
+    template<typename T>
+    static constexpr bool hasDerivedMember = std::is_polymorphic_v<T> && !std::is_final_v<T> && (std::is_base_of_v<T, Types> || ...);
+
+  public:
+
+    template<typename T, typename ... Args>
+    T& emplace(Args&& ... args) {
+      static_assert(isMember<T>, "Not one of the types of the collection");
+      return std::get<std::vector<T>>(segments).emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Copies (or moves) 'object' into the segment of its dynamic type, so that an object passed by a reference to a polymorphic base isn't sliced
+    // into the segment of the base. Throws 'std::invalid_argument' if the dynamic type isn't one of the types of the collection.
+    template<typename T> requires (isMember<std::remove_cvref_t<T>> || hasDerivedMember<std::remove_cvref_t<T>>)
+    std::remove_cvref_t<T>& insert(T&& object) {
+
+      using Base = std::remove_cvref_t<T>;
+
+      if constexpr (hasDerivedMember<Base>) {
+        Base* inserted = nullptr;
+        ([&] {
+          if constexpr (std::is_base_of_v<Base, Types>) {
+            if (!inserted && typeid(object) == typeid(Types)) {
+              using Exact = std::conditional_t<std::is_const_v<std::remove_reference_t<T>>, const Types, Types>;
+              Exact& exact = dynamic_cast<Exact&>(object);
+              if constexpr (std::is_lvalue_reference_v<T>) {
+                inserted = &emplace<Types>(exact);
+              } else {
+                inserted = &emplace<Types>(std::move(exact));
+              }
+            }
+          }
+        }(), ...);
+
+        if (!inserted) {
+          throw std::invalid_argument(std::string("PolyCollection::insert: no segment for objects of type ") + typeid(object).name());
+        }
+        return *inserted;
+      } else {
+        return emplace<Base>(std::forward<T>(object));
+      }
+    }
+
+    template<typename T>
+    void reserve(std::size_t size) {
+      std::get<std::vector<T>>(segments).reserve(size);
+    }
+
+    std::size_t size() const {
+      return std::apply([](const auto& ... segment) { return (segment.size() + ...); }, segments);
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+
+    void clear() {
+      std::apply([](auto& ... segment) { (segment.clear(), ...); }, segments);
+    }
+
+    // The objects of one type
+    template<typename T>
+    std::span<T> segment() {
+      return std::get<std::vector<T>>(segments);
+    }
+
+    template<typename T>
+    std::span<const T> segment() const {
+      return std::get<std::vector<T>>(segments);
+    }
+
+    // Calls 'f' on every object, one segment at a time; 'f' must accept a reference to each of the types
+    template<typename F>
+    void forEach(F&& f) {
+      std::apply([&f](auto& ... segment) {
+        ([&f](auto& objects) {
+          for (auto& object : objects) {
+            f(object);
+          }
+        }(segment), ...);
+      }, segments);
+    }
+
+    template<typename F>
+    void forEach(F&& f) const {
+      std::apply([&f](const auto& ... segment) {
+        ([&f](const auto& objects) {
+          for (const auto& object : objects) {
+            f(object);
+          }
+        }(segment), ...);
+      }, segments);
+    }
+
+  };
+
+}
+
+#endif // CPP_POLYCOLLECTION_H
@@ -1,13 +1,18 @@
 #ifndef TYPES_COMMENTS_H
 #define TYPES_COMMENTS_H
 
+#include "bytecode.h"
 #include "comments.h"
 #include "declarations.h"
 #include "exceptions.h"
 #include "namespaces.h"
+#include "outputSink.h"
+#include "result.h"
 #include "scope.h"
 #include "statements.h"
-//#include "threadsafe.h"
+#include "threadPool.h"
+#include "threadsafe.h"
+#include "transactional.h"
 #include "using.h"
 
 #endif // TYPES_COMMENTS_H
@@ -0,0 +1,124 @@
+#ifndef CONCEPTS_BYTECODE_H
+#define CONCEPTS_BYTECODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "outputSink.h"
+
+/**
+ * A small stack-based bytecode interpreter, which runs the control flow of the statement examples (see "statements.cpp") as data instead of as
+ * compiled code: branches and loops are conditional and unconditional jumps, and a 'switch' with fall-through is a chain of comparisons followed by
+ * case bodies laid out one after another.
+ *
+ * The same program can be run with three dispatch strategies, which differ only in how control passes from one instruction to the next:
+ * - 'Switch': a loop around a 'switch' on the opcode. Every instruction returns to the same indirect jump (after a bounds check), so the branch
+ *   predictor has a single branch from which to predict every transition between instructions.
+ * - 'ComputedGoto': GNU "labels as values". Each handler ends with its own indirect jump through a table of label addresses ('goto *labels[op]'),
+ *   so the predictor learns the likely successor of each instruction separately (threaded code), and there is no bounds check or loop.
+ * - 'TailCall': each handler is a function which ends by calling the handler of the next instruction in tail position. With '[[clang::musttail]]'
+ *   (or '[[gnu::musttail]]') the call is guaranteed to be a jump. GCC versions without the attribute turn it into a jump only when sibling call
+ *   optimization applies (which the handlers enable from -O1), and not in every build (e.g. not at -Og, or with AddressSanitizer); a real call
+ *   uses a stack frame per instruction, so without the attribute this strategy is only supported if a probe finds that every handler jumps. The
+ *   interpreter state (instruction pointer, stack pointer) is passed in registers from handler to handler, instead of living in one large function
+ *   whose register allocation must serve every handler at once.
+ *
+ * Programs are verified when they are constructed (jump targets, local variable indices, and a consistent stack depth at every instruction), so the
+ * interpreters themselves do no checks. The 'concepts/bytecode' benchmarks run the same programs with each strategy.
+ */
+namespace bytecode {
+
+  enum class Op : std::uint8_t {
+    // Pushes the operand
+    Push,
+    // Pushes, or pops into, the local variable with the operand's index
+    Load,
+    Store,
+    // Pop two values and push the result ('Less' and 'Equal' push 1 or 0)
+    Add,
+    Subtract,
+    Multiply,
+    BitAnd,
+    ShiftRight,
+    Less,
+    Equal,
+    // Jump by the operand (relative to this instruction); the conditional jumps pop the condition
+    Jump,
+    JumpIfZero,
+    JumpIfNotZero,
+    // Pops a value and writes it as a character
+    Print,
+    // Stops, returning the value on top of the stack
+    Halt
+  };
+
+  struct Instruction {
+    Op op;
+    std::int32_t operand = 0;
+  };
+
+  inline constexpr std::size_t localCount = 16;
+  inline constexpr std::size_t maxStackDepth = 64;
+
+  class Program {
+
+    std::vector<Instruction> code;
+
+  public:
+
+    // Throws 'std::invalid_argument' if the program isn't valid
+    explicit Program(std::vector<Instruction> code);
+
+    std::span<const Instruction> instructions() const {
+      return code;
+    }
+
+  };
+
+  // Builds a program with symbolic jump targets
+  class Assembler {
+
+    std::vector<Instruction> code;
+    // The instruction index of each label, or -1 while it's unbound
+    std::vector<std::ptrdiff_t> labels;
+    // The index of each jump, and its target label, resolved by 'finish()'
+    std::vector<std::pair<std::size_t, std::size_t>> fixups;
+
+  public:
+
+    using Label = std::size_t;
+
+    Label label();
+
+    // Places the label at the next instruction
+    void bind(Label l);
+
+    Assembler& emit(Op op, std::int32_t operand = 0);
+
+    // 'op' must be one of the jumps
+    Assembler& jump(Op op, Label target);
+
+    // Throws 'std::invalid_argument' if a label is unbound, or the program isn't valid
+    Program finish();
+
+  };
+
+  enum class Dispatch { Switch, ComputedGoto, TailCall };
+
+  bool isSupported(Dispatch dispatch);
+
+  // Runs the program from its first instruction, with all local variables 0; 'dispatch' must be supported
+  std::int64_t run(const Program& program, Dispatch dispatch, output::Sink& out = output::standardOutput());
+
+  // The control flow of 'selectionExample': prints "success" and a newline
+  Program selectionProgram();
+
+  // The control flow of 'jumpExample': returns the final value of 'i' (13)
+  Program jumpProgram();
+
+}
+
+#endif // CONCEPTS_BYTECODE_H
@@ -1,12 +1,68 @@
 #ifndef CONCEPTS_EXCEPTIONS_H
 #define CONCEPTS_EXCEPTIONS_H
 
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include "result.h"
+
 namespace exceptionsExample {
   enum Colour { red, blue, green, yellow };
+
+  // The errors of the Result-based example, one per type of exception thrown by the exception-based example
+  enum class Error { logic, runtime, generic, other };
+
+  enum class ParseError { empty, notADigit, overflow };
+
+  // Parses a non-negative decimal integer, throwing 'std::invalid_argument' or 'std::out_of_range' on malformed input
+  inline int parseOrThrow(std::string_view text) {
+
+    if (text.empty()) {
+      throw std::invalid_argument("Empty");
+    }
+
+    int value = 0;
+    for (char c : text) {
+      if (c < '0' || c > '9') {
+        throw std::invalid_argument("Not a digit");
+      }
+      if (value > (std::numeric_limits<int>::max() - (c - '0')) / 10) {
+        throw std::out_of_range("Overflow");
+      }
+      value = 10 * value + (c - '0');
+    }
+
+    return value;
+  }
+
+  // Parses a non-negative decimal integer, returning the error on malformed input
+  inline results::Result<int, ParseError> parse(std::string_view text) {
+
+    if (text.empty()) {
+      return results::fail(ParseError::empty);
+    }
+
+    int value = 0;
+    for (char c : text) {
+      if (c < '0' || c > '9') {
+        return results::fail(ParseError::notADigit);
+      }
+      if (value > (std::numeric_limits<int>::max() - (c - '0')) / 10) {
+        return results::fail(ParseError::overflow);
+      }
+      value = 10 * value + (c - '0');
+    }
+
+    return value;
+  }
 }
 
 struct AlwaysFailsToBuild;
 
 void exceptionCatcher();
 
+// The same control flow as 'exceptionCatcher', with errors returned as Results instead of thrown
+void resultCatcher();
+
 #endif // CONCEPTS_EXCEPTIONS_H
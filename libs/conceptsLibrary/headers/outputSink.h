@@ -0,0 +1,123 @@
+#ifndef CONCEPTS_OUTPUTSINK_H
+#define CONCEPTS_OUTPUTSINK_H
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+/**
+ * Buffered output straight to a file descriptor. Writing to 'std::cout' one character at a time is slow for reasons which have nothing to do with
+ * the output: each '<<' constructs a sentry (which checks the stream state and flushes any tied stream), consults the locale, and, while the stream
+ * is synchronized with C stdio (the default), hands every character to 'putc' on 'stdout', which takes a lock. 'std::endl' adds a flush, and
+ * therefore a system call, per line.
+ *
+ * A 'Sink' has none of this: putting a character is a store into a user-space buffer and an increment, and the buffer is passed to 'write(2)' only
+ * when it's full, when 'flush()' is called, or (with 'Flush::eachLine') at the end of each line. A string which doesn't fit into the remaining
+ * space is written together with the buffered bytes by a single 'writev(2)', without being copied. Bytes are written as they are: there is no
+ * locale, formatting state, or character conversion.
+ *
+ *   output::Sink out(fd);
+ *   out << "count: " << 42 << '\n';
+ *   out.flush();                      // Also done by the destructor
+ *
+ * A sink isn't thread-safe. Output written to the same descriptor through other means (e.g. 'std::cout') may appear out of order, unless both are
+ * flushed in turn.
+ */
+namespace output {
+
+  enum class Flush {
+    // When the buffer is full, on 'flush()', and on destruction
+    whenFull,
+    // As above, and also after every '\n' (like a terminal)
+    eachLine
+  };
+
+  class Sink {
+
+    int descriptor;
+    std::unique_ptr<char[]> buffer;
+    std::size_t capacity;
+    std::size_t used = 0;
+    Flush policy;
+
+    // Writes the buffered bytes followed by 's' (which may be empty), and empties the buffer
+    void drain(std::string_view s = {});
+
+  public:
+
+    static constexpr std::size_t defaultCapacity = 64 * 1024;
+
+    // Throws 'std::invalid_argument' if 'capacity' is 0
+    explicit Sink(int descriptor, std::size_t capacity = defaultCapacity, Flush policy = Flush::whenFull);
+
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+
+    // Flushes; errors are ignored, since destructors must not throw (call 'flush()' first to see them)
+    ~Sink();
+
+    // Throws 'std::system_error' if the descriptor can't be written to
+    void flush();
+
+    void put(char c) {
+      if (used == capacity) [[unlikely]] {
+        drain();
+      }
+      buffer[used++] = c;
+      if (policy == Flush::eachLine && c == '\n') {
+        flush();
+      }
+    }
+
+    void write(std::string_view s) {
+      if (s.size() <= capacity - used) [[likely]] {
+        std::memcpy(buffer.get() + used, s.data(), s.size());
+        used += s.size();
+      } else {
+        drain(s);
+      }
+      if (policy == Flush::eachLine && s.find('\n') != std::string_view::npos) {
+        flush();
+      }
+    }
+
+    Sink& operator<<(char c) {
+      put(c);
+      return *this;
+    }
+
+    Sink& operator<<(std::string_view s) {
+      write(s);
+      return *this;
+    }
+
+    Sink& operator<<(const char* s) {
+      write(s);
+      return *this;
+    }
+
+    template<std::integral T>
+    requires (!std::same_as<T, char> && !std::same_as<T, bool>)
+    Sink& operator<<(T value) {
+      char digits[24];
+      auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+      write(std::string_view(digits, end - digits));
+      return *this;
+    }
+
+    // The number of bytes waiting to be written
+    std::size_t buffered() const {
+      return used;
+    }
+
+  };
+
+  // A sink on standard output, which flushes each line (so that interactive output appears promptly), and is flushed at exit
+  Sink& standardOutput();
+
+}
+
+#endif // CONCEPTS_OUTPUTSINK_H
@@ -0,0 +1,298 @@
+#ifndef CONCEPTS_RESULT_H
+#define CONCEPTS_RESULT_H
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * Errors as values: a 'Result<T, E>' holds either a value of type 'T' (success) or an error of type 'E' (failure), like C++23's 'std::expected'.
+ *
+ * Exceptions cost nothing while nothing is thrown, but throwing one is slow: the exception is allocated on the heap, and the unwinder looks up the
+ * unwind tables of every frame between the 'throw' and the 'catch', taking a global lock to do so. When failures are part of normal operation (e.g. a
+ * parser fed malformed input), returning the error instead costs a branch in every caller, but failing costs no more than succeeding.
+ *
+ * Results are chained without checking each step by hand:
+ *
+ *   results::Result<int, ParseError> port = parse(text)
+ *       .andThen(checkRange)                          // Only called on success; returns another Result
+ *       .transform([](int p) { return p + offset; }); // Only called on success; returns a plain value
+ *
+ * or returned early from the enclosing function with 'RESULT_TRY' (see below), which takes the place of letting an exception propagate.
+ */
+namespace results {
+
+  // The error of a failed Result, wrapped so that a Result can be constructed from it even if 'T' and 'E' are the same type
+  template<typename E>
+  struct Failure {
+    E error;
+  };
+
+  template<typename E>
+  constexpr Failure<std::decay_t<E>> fail(E&& error) {
+    return {std::forward<E>(error)};
+  }
+
+  // Thrown by 'value()' when a Result holds an error: a logic error, since the caller should have checked first
+  struct BadResultAccess : std::logic_error {
+    BadResultAccess(): std::logic_error("Result holds an error") {}
+  };
+
+  template<typename T, typename E>
+  class Result;
+
+  namespace detail {
+
+    template<typename R>
+    struct IsResult : std::false_type {};
+
+    template<typename T, typename E>
+    struct IsResult<Result<T, E>> : std::true_type {};
+
+    template<typename T>
+    using Stored = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    // Calls 'f' with the value of 'r', or without arguments if the value is 'void'
+    template<typename F, typename R>
+    constexpr decltype(auto) invokeWithValue(F&& f, R&& r) {
+      if constexpr (std::is_void_v<typename std::remove_cvref_t<R>::value_type>) {
+        return std::invoke(std::forward<F>(f));
+      } else {
+        return std::invoke(std::forward<F>(f), *std::forward<R>(r));
+      }
+    }
+
+  }
+
+  template<typename T, typename E>
+  class [[nodiscard]] Result {
+
+    template<typename, typename>
+    friend class Result;
+
+    std::variant<detail::Stored<T>, Failure<E>> state;
+
+    template<std::size_t I, typename ... Args>
+    constexpr explicit Result(std::in_place_index_t<I> index, Args&& ... args): state(index, std::forward<Args>(args)...) {}
+
+    using Reference = std::add_lvalue_reference_t<T>;
+    using ConstReference = std::conditional_t<std::is_void_v<T>, void, const detail::Stored<T>&>;
+
+  public:
+
+    using value_type = T;
+    using error_type = E;
+
+    constexpr Result() requires std::is_default_constructible_v<detail::Stored<T>> = default;
+
+    template<typename U = detail::Stored<T>>
+    requires (!std::is_void_v<T> && std::is_constructible_v<T, U&&> && !detail::IsResult<std::remove_cvref_t<U>>::value)
+    constexpr Result(U&& value): state(std::in_place_index<0>, std::forward<U>(value)) {}
+
+    template<typename G>
+    requires std::is_constructible_v<E, G&&>
+    constexpr Result(Failure<G> failure): state(std::in_place_index<1>, Failure<E>{E(std::move(failure.error))}) {}
+
+    constexpr bool ok() const {
+      return state.index() == 0;
+    }
+
+    constexpr explicit operator bool() const {
+      return ok();
+    }
+
+    // The value; throws 'BadResultAccess' if this is an error
+    constexpr decltype(auto) value() & {
+      check();
+      return **this;
+    }
+
+    constexpr decltype(auto) value() const & {
+      check();
+      return **this;
+    }
+
+    // Moves the value out, rather than referring to it, so that the value outlives a temporary Result
+    constexpr T value() && {
+      check();
+      if constexpr (!std::is_void_v<T>) {
+        return std::move(*std::get_if<0>(&state));
+      }
+    }
+
+    // The value, without checking that there is one
+    constexpr Reference operator*() & {
+      if constexpr (!std::is_void_v<T>) {
+        return *std::get_if<0>(&state);
+      }
+    }
+
+    constexpr ConstReference operator*() const & {
+      if constexpr (!std::is_void_v<T>) {
+        return *std::get_if<0>(&state);
+      }
+    }
+
+    constexpr std::add_rvalue_reference_t<T> operator*() && {
+      if constexpr (!std::is_void_v<T>) {
+        return std::move(*std::get_if<0>(&state));
+      }
+    }
+
+    constexpr auto* operator->() requires (!std::is_void_v<T>) {
+      return std::get_if<0>(&state);
+    }
+
+    constexpr const auto* operator->() const requires (!std::is_void_v<T>) {
+      return std::get_if<0>(&state);
+    }
+
+    // The error, without checking that there is one
+    constexpr E& error() & {
+      return std::get_if<1>(&state)->error;
+    }
+
+    constexpr const E& error() const & {
+      return std::get_if<1>(&state)->error;
+    }
+
+    constexpr E&& error() && {
+      return std::move(std::get_if<1>(&state)->error);
+    }
+
+    template<typename U>
+    requires (!std::is_void_v<T>)
+    constexpr T valueOr(U&& fallback) const & {
+      return ok() ? **this : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template<typename U>
+    requires (!std::is_void_v<T>)
+    constexpr T valueOr(U&& fallback) && {
+      return ok() ? std::move(**this) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    // On success, returns 'f(value)', which must return a Result with the same error type; on failure, returns the error
+    template<typename F>
+    constexpr auto andThen(F&& f) const & {
+      return andThen(*this, std::forward<F>(f));
+    }
+
+    template<typename F>
+    constexpr auto andThen(F&& f) && {
+      return andThen(std::move(*this), std::forward<F>(f));
+    }
+
+    // On success, returns 'f(value)' as a successful Result; on failure, returns the error
+    template<typename F>
+    constexpr auto transform(F&& f) const & {
+      return transform(*this, std::forward<F>(f));
+    }
+
+    template<typename F>
+    constexpr auto transform(F&& f) && {
+      return transform(std::move(*this), std::forward<F>(f));
+    }
+
+    // On failure, returns 'f(error)', which must return a Result with the same value type; on success, returns the value
+    template<typename F>
+    constexpr auto orElse(F&& f) const & {
+      return orElse(*this, std::forward<F>(f));
+    }
+
+    template<typename F>
+    constexpr auto orElse(F&& f) && {
+      return orElse(std::move(*this), std::forward<F>(f));
+    }
+
+    // On failure, returns 'f(error)' as the error; on success, returns the value
+    template<typename F>
+    constexpr auto transformError(F&& f) const & {
+      return transformError(*this, std::forward<F>(f));
+    }
+
+    template<typename F>
+    constexpr auto transformError(F&& f) && {
+      return transformError(std::move(*this), std::forward<F>(f));
+    }
+
+  private:
+
+    constexpr void check() const {
+      if (!ok()) {
+        throw BadResultAccess();
+      }
+    }
+
+    template<typename R, typename F>
+    static constexpr auto andThen(R&& self, F&& f) {
+      using Next = std::remove_cvref_t<decltype(detail::invokeWithValue(std::forward<F>(f), std::forward<R>(self)))>;
+      static_assert(detail::IsResult<Next>::value && std::is_same_v<typename Next::error_type, E>, "'andThen' must return a Result with the same error type");
+      if (self.ok()) {
+        return detail::invokeWithValue(std::forward<F>(f), std::forward<R>(self));
+      }
+      return Next(Failure<E>{std::forward<R>(self).error()});
+    }
+
+    template<typename R, typename F>
+    static constexpr auto transform(R&& self, F&& f) {
+      using U = std::remove_cv_t<decltype(detail::invokeWithValue(std::forward<F>(f), std::forward<R>(self)))>;
+      if (!self.ok()) {
+        return Result<U, E>(Failure<E>{std::forward<R>(self).error()});
+      }
+      if constexpr (std::is_void_v<U>) {
+        detail::invokeWithValue(std::forward<F>(f), std::forward<R>(self));
+        return Result<U, E>();
+      } else {
+        return Result<U, E>(detail::invokeWithValue(std::forward<F>(f), std::forward<R>(self)));
+      }
+    }
+
+    template<typename R, typename F>
+    static constexpr auto orElse(R&& self, F&& f) {
+      using Next = std::remove_cvref_t<decltype(std::invoke(std::forward<F>(f), std::forward<R>(self).error()))>;
+      static_assert(detail::IsResult<Next>::value && std::is_same_v<typename Next::value_type, T>, "'orElse' must return a Result with the same value type");
+      if (!self.ok()) {
+        return std::invoke(std::forward<F>(f), std::forward<R>(self).error());
+      }
+      return Next(std::in_place_index<0>, std::move(*std::get_if<0>(&self.state)));
+    }
+
+    template<typename R, typename F>
+    static constexpr auto transformError(R&& self, F&& f) {
+      using G = std::remove_cv_t<decltype(std::invoke(std::forward<F>(f), std::forward<R>(self).error()))>;
+      if (self.ok()) {
+        return Result<T, G>(std::in_place_index<0>, std::move(*std::get_if<0>(&self.state)));
+      }
+      return Result<T, G>(std::in_place_index<1>, Failure<G>{std::invoke(std::forward<F>(f), std::forward<R>(self).error())});
+    }
+
+  };
+
+}
+
+/**
+ * Evaluates 'expression', which must produce a Result: on failure, returns its error from the enclosing function (which must return a Result with a
+ * compatible error type); on success, evaluates to its value. This is the explicit equivalent of an exception propagating through a function, e.g.
+ *
+ *   results::Result<Config, ParseError> load(std::string_view text) {
+ *     int port = RESULT_TRY(parsePort(text));
+ *     RESULT_TRY(validate(port));
+ *     return Config{port};
+ *   }
+ *
+ * Uses a statement expression (a GCC extension, also supported by Clang), since standard C++ has no expression which can return early.
+ */
+#define RESULT_TRY(expression)                                               \
+  ({                                                                         \
+    auto&& resultTryValue_ = (expression);                                   \
+    if (!resultTryValue_.ok()) {                                             \
+      return ::results::fail(std::move(resultTryValue_).error());            \
+    }                                                                        \
+    std::move(resultTryValue_).value();                                      \
+  })
+
+#endif // CONCEPTS_RESULT_H
@@ -1,10 +1,18 @@
 #ifndef CONCEPTS_STATEMENTS_H
 #define CONCEPTS_STATEMENTS_H
 
+#include "outputSink.h"
+
+// See "bytecode.h" for the control flow of 'selectionExample' and 'jumpExample' as interpreted bytecode
 void selectionExample();
 
-void iterationExample();
+// Prints one character at a time, so it writes to a buffered sink rather than to 'std::cout' (see "outputSink.h")
+void iterationExample(output::Sink& out = output::standardOutput());
 
 void jumpExample();
 
+// Runs the bytecode versions of 'selectionExample' and 'jumpExample' with every supported dispatch strategy, and checks that each prints "success"
+// and returns 13 respectively (see "bytecode.h")
+void bytecodeExample();
+
 #endif // CONCEPTS_STATEMENTS_H
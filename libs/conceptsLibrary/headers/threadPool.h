@@ -0,0 +1,140 @@
+#ifndef CONCEPTS_THREADPOOL_H
+#define CONCEPTS_THREADPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform.h"
+
+/**
+ * A work-stealing thread pool. Spawning an OS thread per task costs tens of microseconds; a pool keeps a fixed set of worker threads alive and hands
+ * tasks to them instead.
+ *
+ * Each worker owns a Chase-Lev deque: the worker pushes and pops tasks at the bottom of its own deque without any locking, while idle workers steal
+ * tasks from the top of the deques of randomly chosen victims. Tasks submitted from inside a worker (e.g. tasks which spawn sub-tasks) go to that
+ * worker's deque; tasks submitted from other threads go to a shared injection queue.
+ *
+ * Workers which find no work park on a futex, and are woken by subsequent submissions.
+ */
+namespace concurrency {
+
+  class ThreadPool {
+
+    struct Task {
+      virtual void run() = 0;
+      virtual ~Task() = default;
+    };
+
+    template<typename F>
+    struct TaskFor : Task {
+      F f;
+      explicit TaskFor(F&& f): f(std::move(f)) {}
+      void run() override { f(); }
+    };
+
+    /**
+     * Chase-Lev work-stealing deque, with the memory orderings of "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013). The
+     * owner pushes and takes at the bottom; thieves steal at the top. The buffer grows when full; retired buffers are kept until the deque is
+     * destroyed, since a thief may still be reading from them.
+     */
+    class Deque {
+
+      struct Buffer {
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+
+        explicit Buffer(std::int64_t c): capacity(c), slots(new std::atomic<Task*>[c]) {}
+
+        Task* get(std::int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(std::int64_t i, Task* t) { slots[i & (capacity - 1)].store(t, std::memory_order_relaxed); }
+      };
+
+      alignas(64) std::atomic<std::int64_t> top = 0;
+      alignas(64) std::atomic<std::int64_t> bottom = 0;
+      std::atomic<Buffer*> buffer;
+      std::vector<std::unique_ptr<Buffer>> buffers;
+
+    public:
+
+      Deque();
+
+      // Owner only
+      void push(Task* task);
+
+      // Owner only; returns nullptr if the deque is empty
+      Task* take();
+
+      // Any thread; returns nullptr if the deque is empty or the steal lost a race
+      Task* steal();
+
+      bool empty() const;
+
+    };
+
+    struct Worker {
+      Deque deque;
+      std::thread thread;
+      std::uint64_t random;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectionLock;
+    std::deque<Task*> injected;
+    std::atomic<std::size_t> injectedCount = 0;
+
+    // Parking protocol: submitters increment 'epoch' after publishing a task, and wake a sleeper if there is one. Workers read 'epoch', announce
+    // themselves as sleepers, re-check for work, and only then wait for 'epoch' to change. A submission can therefore never be missed.
+    alignas(64) std::atomic<std::uint32_t> epoch = 0;
+    std::atomic<std::uint32_t> sleepers = 0;
+    std::atomic<bool> stopping = false;
+
+    void schedule(Task* task);
+
+    Task* findWork(unsigned self);
+
+    void workerLoop(unsigned self);
+
+    void park(std::uint32_t observed);
+
+    void wake(int count);
+
+  public:
+
+    explicit ThreadPool(unsigned threads = platform::availableCpus());
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs all tasks which were already submitted, then joins the workers
+    ~ThreadPool();
+
+    unsigned size() const {
+      return static_cast<unsigned>(workers.size());
+    }
+
+    template<typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F&& f) {
+
+      using R = std::invoke_result_t<std::decay_t<F>>;
+
+      std::packaged_task<R()> task(std::forward<F>(f));
+      std::future<R> result = task.get_future();
+      schedule(new TaskFor<std::packaged_task<R()>>(std::move(task)));
+
+      return result;
+    }
+
+  };
+
+}
+
+#endif // CONCEPTS_THREADPOOL_H
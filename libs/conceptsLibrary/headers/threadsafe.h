@@ -3,6 +3,6 @@
 
 void synchronizedExample();
 
-void atomicExample();
+void atomicExample(int a, int b, int c);
 
 #endif // CONCEPTS_THREADSAFE_H
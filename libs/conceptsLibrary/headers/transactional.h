@@ -0,0 +1,243 @@
+#ifndef CONCEPTS_TRANSACTIONAL_H
+#define CONCEPTS_TRANSACTIONAL_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A word-based software transactional memory (STM), following the "Transactional Locking II" (TL2) design. It provides the 'atomic_noexcept',
+ * 'atomic_cancel', and 'atomic_commit' blocks of the Transactional Memory TS as library functions, since GCC does not implement 'atomic_cancel' and
+ * its '-fgnu-tm' support is experimental.
+ *
+ * Memory is covered by a table of versioned locks; every word of memory maps to one lock. A global version clock is sampled when a transaction
+ * begins. Every transactional read checks that the lock covering the location is free and no newer than the sampled clock, so a transaction only
+ * ever observes a consistent snapshot of memory. Writes are buffered in the transaction. On commit, the locks covering the written locations are
+ * acquired, the clock is incremented, the locations read are re-validated, and the buffered writes are published with the new version. Any conflict
+ * aborts the attempt, which is then retried from the start.
+ *
+ * Within a transaction, shared memory must only be accessed through 'Transaction::load' and 'Transaction::store'. The transaction body may be
+ * executed more than once, so it must not perform irreversible actions (e.g. I/O). Attempts are aborted by throwing an internal exception, which the
+ * body must not swallow with 'catch (...)'. Transactions nested in other transactions are flattened into the outermost transaction.
+ */
+namespace stm {
+
+  class Transaction {
+
+    struct Write {
+      void* address;
+      std::uint64_t value;
+      std::uint32_t lock;
+      void (*publish)(void* address, const std::uint64_t& value);
+    };
+
+    struct Acquired {
+      std::uint32_t lock;
+      std::uint64_t previous;
+    };
+
+    std::uint64_t readVersion = 0;
+    std::uint64_t writeFilter = 0;
+    std::vector<std::uint32_t> reads;
+    std::vector<Write> writes;
+    std::vector<Acquired> acquired;
+
+    static std::uint32_t lockFor(const void* address);
+
+    static std::uint64_t filterBit(const void* address) {
+      return std::uint64_t(1) << ((reinterpret_cast<std::uintptr_t>(address) >> 3) & 63);
+    }
+
+    // Returns the lock word of 'lock' if it's free and no newer than the read version; otherwise, aborts
+    std::uint64_t checkLock(std::uint32_t lock) const;
+
+    // Called after a read of a location covered by 'lock', with the lock word observed before the read
+    void validateRead(std::uint32_t lock, std::uint64_t before);
+
+    template<typename T>
+    static void publishAs(void* address, const std::uint64_t& value) {
+      T v;
+      std::memcpy(&v, &value, sizeof(T));
+      std::atomic_ref<T>(*static_cast<T*>(address)).store(v, std::memory_order_relaxed);
+    }
+
+    void releaseLocks();
+
+  public:
+
+    template<typename T>
+    T load(const T& location) {
+
+      static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(std::uint64_t), "Only word-sized objects can be accessed");
+
+      if (writeFilter & filterBit(&location)) {
+        for (auto w = writes.rbegin(); w != writes.rend(); ++w) {
+          if (w->address == &location) {
+            T v;
+            std::memcpy(&v, &w->value, sizeof(T));
+            return v;
+          }
+        }
+      }
+
+      std::uint32_t lock = lockFor(&location);
+      std::uint64_t before = checkLock(lock);
+      T v = std::atomic_ref<T>(const_cast<T&>(location)).load(std::memory_order_relaxed);
+      validateRead(lock, before);
+
+      return v;
+    }
+
+    template<typename T>
+    void store(T& location, T value) {
+
+      static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(std::uint64_t), "Only word-sized objects can be accessed");
+
+      std::uint64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(T));
+
+      if (writeFilter & filterBit(&location)) {
+        for (Write& w : writes) {
+          if (w.address == &location) {
+            w.value = bits;
+            return;
+          }
+        }
+      }
+
+      writeFilter |= filterBit(&location);
+      writes.push_back({&location, bits, lockFor(&location), &publishAs<T>});
+    }
+
+    // Starts a new attempt
+    void begin();
+
+    // Publishes the buffered writes; returns false if the attempt conflicted with another transaction and must be retried
+    bool commit();
+
+    // Discards the buffered writes
+    void rollback();
+
+  };
+
+  // Thrown to abort the current attempt of a transaction; never escapes the transaction functions below
+  struct Conflict {};
+
+  namespace detail {
+
+    Transaction*& current();
+
+    Transaction& local();
+
+    // Waits for a short, increasing, amount of time before the next attempt, to reduce repeated conflicts
+    void backoff(unsigned attempt);
+
+    template<typename E, typename ... Es>
+    bool isOneOf(const std::exception_ptr& e) {
+
+      try {
+        std::rethrow_exception(e);
+      } catch (const E&) {
+        return true;
+      } catch (...) {
+        if constexpr (sizeof...(Es) > 0) {
+          return isOneOf<Es...>(e);
+        } else {
+          return false;
+        }
+      }
+    }
+
+    enum class OnException { Rollback, Cancel, Commit };
+
+    template<OnException Policy, typename ... Approved, typename F>
+    void run(F&& body) {
+
+      // Flat nesting: a nested transaction becomes part of the enclosing one
+      if (Transaction* outer = current()) {
+        body(*outer);
+        return;
+      }
+
+      Transaction& tx = local();
+      current() = &tx;
+
+      for (unsigned attempt = 0;; ++attempt) {
+        tx.begin();
+
+        try {
+          body(tx);
+
+        } catch (const Conflict&) {
+          tx.rollback();
+          backoff(attempt);
+          continue;
+
+        } catch (...) {
+          std::exception_ptr e = std::current_exception();
+
+          if constexpr (Policy == OnException::Commit) {
+            // The writes made before the exception are published, unless they conflicted, in which case the transaction is retried
+            if (!tx.commit()) {
+              backoff(attempt);
+              continue;
+            }
+
+          } else {
+            tx.rollback();
+          }
+
+          current() = nullptr;
+          if constexpr (Policy == OnException::Cancel && sizeof...(Approved) > 0) {
+            if (isOneOf<Approved...>(e)) {
+              return;
+            }
+          }
+          std::rethrow_exception(e);
+        }
+
+        if (tx.commit()) {
+          current() = nullptr;
+          return;
+        }
+        backoff(attempt);
+      }
+    }
+
+  }
+
+  // If an exception escapes the body, the transaction is rolled back and the exception continues propagating
+  template<typename F>
+  void atomicNoexcept(F&& body) {
+    detail::run<detail::OnException::Rollback>(std::forward<F>(body));
+  }
+
+  // If an exception escapes the body, the transaction is rolled back; exceptions of the approved types are then swallowed (the transaction is just
+  // cancelled), while all other exceptions continue propagating
+  template<typename ... Approved, typename F>
+  void atomicCancel(F&& body) {
+    detail::run<detail::OnException::Cancel, Approved...>(std::forward<F>(body));
+  }
+
+  // If an exception escapes the body, the writes made so far are committed and the exception continues propagating
+  template<typename F>
+  void atomicCommit(F&& body) {
+    detail::run<detail::OnException::Commit>(std::forward<F>(body));
+  }
+
+  // Executes the body while holding a single global lock, like the 'synchronized' block of the Transactional Memory TS. Synchronized blocks are
+  // serialized with each other, but not with transactions.
+  void synchronized(void (*body)(void*), void* context);
+
+  template<typename F>
+  void synchronized(F&& body) {
+    synchronized([](void* f) { (*static_cast<std::remove_reference_t<F>*>(f))(); }, &body);
+  }
+
+}
+
+#endif // CONCEPTS_TRANSACTIONAL_H
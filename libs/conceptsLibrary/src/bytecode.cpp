@@ -0,0 +1,447 @@
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#include "bytecode.h"
+
+// A call in tail position which is guaranteed to be compiled as a jump, so that a chain of handlers runs in constant stack space
+#if defined(__has_cpp_attribute) && __has_cpp_attribute(clang::musttail)
+#define BYTECODE_MUSTTAIL [[clang::musttail]]
+#define BYTECODE_GUARANTEED_TAIL_CALLS
+#elif defined(__has_cpp_attribute) && __has_cpp_attribute(gnu::musttail)
+#define BYTECODE_MUSTTAIL [[gnu::musttail]]
+#define BYTECODE_GUARANTEED_TAIL_CALLS
+#else
+#define BYTECODE_MUSTTAIL
+#endif
+
+// Without the attribute, GCC only turns a call in tail position into a jump with '-foptimize-sibling-calls' (enabled from -O2), which the handlers
+// enable for themselves. Even then some builds keep real calls (e.g. at -Og, or in the 'Print' handler with AddressSanitizer), so 'isSupported'
+// checks what the build actually does.
+#if !defined(BYTECODE_GUARANTEED_TAIL_CALLS) && defined(__GNUC__)
+#define BYTECODE_SIBLING_CALLS [[gnu::optimize("optimize-sibling-calls")]]
+#define BYTECODE_PROBE_TAIL_CALLS
+#else
+#define BYTECODE_SIBLING_CALLS
+#endif
+
+namespace bytecode {
+
+  namespace {
+
+    constexpr std::size_t opCount = static_cast<std::size_t>(Op::Halt) + 1;
+
+    struct StackEffect {
+      int pops;
+      int pushes;
+    };
+
+    constexpr StackEffect stackEffects[opCount] = {
+      {0, 1}, {0, 1}, {1, 0},                                 // Push, Load, Store
+      {2, 1}, {2, 1}, {2, 1}, {2, 1}, {2, 1}, {2, 1}, {2, 1}, // Add, Subtract, Multiply, BitAnd, ShiftRight, Less, Equal
+      {0, 0}, {1, 0}, {1, 0},                                 // Jump, JumpIfZero, JumpIfNotZero
+      {1, 0}, {1, 0}                                          // Print, Halt
+    };
+
+    [[noreturn]] void invalid(const std::string& reason, std::size_t index) {
+      throw std::invalid_argument("bytecode::Program: " + reason + " at instruction " + std::to_string(index));
+    }
+
+    // Integer arithmetic wraps around, as in unsigned arithmetic, rather than overflowing
+    std::int64_t wrap(std::uint64_t value) {
+      return static_cast<std::int64_t>(value);
+    }
+
+    // The effect of one instruction, shared by all dispatch strategies; returns the offset of the next instruction. Always inlined, so that each
+    // strategy compiles to the same handler code, and only its dispatch differs.
+    template<Op O>
+    [[gnu::always_inline]] inline std::ptrdiff_t execute(const Instruction* ip, std::int64_t*& sp, std::int64_t* locals, output::Sink& out) {
+
+      if constexpr (O == Op::Push) {
+        *sp++ = ip->operand;
+      } else if constexpr (O == Op::Load) {
+        *sp++ = locals[ip->operand];
+      } else if constexpr (O == Op::Store) {
+        locals[ip->operand] = *--sp;
+      } else if constexpr (O == Op::Jump) {
+        return ip->operand;
+      } else if constexpr (O == Op::JumpIfZero) {
+        return (*--sp == 0) ? ip->operand : 1;
+      } else if constexpr (O == Op::JumpIfNotZero) {
+        return (*--sp != 0) ? ip->operand : 1;
+      } else if constexpr (O == Op::Print) {
+        out.put(static_cast<char>(*--sp));
+      } else {
+        std::int64_t b = *--sp;
+        std::int64_t& a = sp[-1];
+        if constexpr (O == Op::Add) {
+          a = wrap(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+        } else if constexpr (O == Op::Subtract) {
+          a = wrap(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+        } else if constexpr (O == Op::Multiply) {
+          a = wrap(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+        } else if constexpr (O == Op::BitAnd) {
+          a &= b;
+        } else if constexpr (O == Op::ShiftRight) {
+          a >>= (b & 63);
+        } else if constexpr (O == Op::Less) {
+          a = (a < b);
+        } else {
+          static_assert(O == Op::Equal);
+          a = (a == b);
+        }
+      }
+      return 1;
+    }
+
+    std::int64_t runSwitch(const Instruction* ip, std::int64_t* sp, std::int64_t* locals, output::Sink& out) {
+
+      for (;;) {
+        switch (ip->op) {
+          case Op::Push: ip += execute<Op::Push>(ip, sp, locals, out); break;
+          case Op::Load: ip += execute<Op::Load>(ip, sp, locals, out); break;
+          case Op::Store: ip += execute<Op::Store>(ip, sp, locals, out); break;
+          case Op::Add: ip += execute<Op::Add>(ip, sp, locals, out); break;
+          case Op::Subtract: ip += execute<Op::Subtract>(ip, sp, locals, out); break;
+          case Op::Multiply: ip += execute<Op::Multiply>(ip, sp, locals, out); break;
+          case Op::BitAnd: ip += execute<Op::BitAnd>(ip, sp, locals, out); break;
+          case Op::ShiftRight: ip += execute<Op::ShiftRight>(ip, sp, locals, out); break;
+          case Op::Less: ip += execute<Op::Less>(ip, sp, locals, out); break;
+          case Op::Equal: ip += execute<Op::Equal>(ip, sp, locals, out); break;
+          case Op::Jump: ip += execute<Op::Jump>(ip, sp, locals, out); break;
+          case Op::JumpIfZero: ip += execute<Op::JumpIfZero>(ip, sp, locals, out); break;
+          case Op::JumpIfNotZero: ip += execute<Op::JumpIfNotZero>(ip, sp, locals, out); break;
+          case Op::Print: ip += execute<Op::Print>(ip, sp, locals, out); break;
+          case Op::Halt: return sp[-1];
+        }
+      }
+    }
+
+#if defined(__GNUC__)
+    std::int64_t runComputedGoto(const Instruction* ip, std::int64_t* sp, std::int64_t* locals, output::Sink& out) {
+
+      // In the order of 'Op'
+      static void* const labels[opCount] = {&&Push, &&Load, &&Store, &&Add, &&Subtract, &&Multiply, &&BitAnd, &&ShiftRight, &&Less, &&Equal, &&Jump,
+                                            &&JumpIfZero, &&JumpIfNotZero, &&Print, &&Halt};
+
+// Every handler ends with its own copy of the dispatch
+#define BYTECODE_DISPATCH() goto *labels[static_cast<std::size_t>(ip->op)]
+#define BYTECODE_HANDLER(name) name: ip += execute<Op::name>(ip, sp, locals, out); BYTECODE_DISPATCH();
+
+      BYTECODE_DISPATCH();
+
+      BYTECODE_HANDLER(Push)
+      BYTECODE_HANDLER(Load)
+      BYTECODE_HANDLER(Store)
+      BYTECODE_HANDLER(Add)
+      BYTECODE_HANDLER(Subtract)
+      BYTECODE_HANDLER(Multiply)
+      BYTECODE_HANDLER(BitAnd)
+      BYTECODE_HANDLER(ShiftRight)
+      BYTECODE_HANDLER(Less)
+      BYTECODE_HANDLER(Equal)
+      BYTECODE_HANDLER(Jump)
+      BYTECODE_HANDLER(JumpIfZero)
+      BYTECODE_HANDLER(JumpIfNotZero)
+      BYTECODE_HANDLER(Print)
+
+#undef BYTECODE_HANDLER
+#undef BYTECODE_DISPATCH
+
+      Halt:
+      return sp[-1];
+    }
+#endif
+
+    using Handler = std::int64_t (*)(const Instruction* ip, std::int64_t* sp, std::int64_t* locals, output::Sink& out);
+
+    extern const Handler handlers[opCount];
+
+#if defined(BYTECODE_PROBE_TAIL_CALLS)
+    // The frame in which this thread last ran the 'Halt' handler (see 'tailCallsAreJumps')
+    thread_local std::uintptr_t haltFrame = 0;
+#endif
+
+    template<Op O>
+    BYTECODE_SIBLING_CALLS std::int64_t handle(const Instruction* ip, std::int64_t* sp, std::int64_t* locals, output::Sink& out) {
+      if constexpr (O == Op::Halt) {
+#if defined(BYTECODE_PROBE_TAIL_CALLS)
+        haltFrame = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+#endif
+        return sp[-1];
+      } else {
+        ip += execute<O>(ip, sp, locals, out);
+        BYTECODE_MUSTTAIL return handlers[static_cast<std::size_t>(ip->op)](ip, sp, locals, out);
+      }
+    }
+
+    const Handler handlers[opCount] = {handle<Op::Push>, handle<Op::Load>, handle<Op::Store>, handle<Op::Add>, handle<Op::Subtract>,
+                                       handle<Op::Multiply>, handle<Op::BitAnd>, handle<Op::ShiftRight>, handle<Op::Less>, handle<Op::Equal>,
+                                       handle<Op::Jump>, handle<Op::JumpIfZero>, handle<Op::JumpIfNotZero>, handle<Op::Print>, handle<Op::Halt>};
+
+#if defined(BYTECODE_PROBE_TAIL_CALLS)
+    // Runs a loop which executes every instruction 'iterations' times with tail calls, and returns the frame in which it halted. Not inlined, so
+    // that every call starts the handlers at the same depth.
+    [[gnu::noinline]] std::uintptr_t haltFrameAfter(std::int32_t iterations) {
+
+      constexpr std::int32_t i = 0;
+      Assembler a;
+      auto loop = a.label();
+      auto notNegative = a.label();
+      auto end = a.label();
+
+      a.emit(Op::Push, iterations).emit(Op::Store, i);
+      a.bind(loop);
+      a.emit(Op::Load, i).emit(Op::Push, 1).emit(Op::Subtract).emit(Op::Store, i);
+      a.emit(Op::Push, 60).emit(Op::Push, 2).emit(Op::Multiply).emit(Op::Push, 1).emit(Op::ShiftRight);
+      a.emit(Op::Push, 127).emit(Op::BitAnd).emit(Op::Push, 0).emit(Op::Add).emit(Op::Print);
+      a.emit(Op::Load, i).emit(Op::Push, 0).emit(Op::Less).jump(Op::JumpIfZero, notNegative);
+      a.bind(notNegative);
+      a.emit(Op::Load, i).emit(Op::Push, 0).emit(Op::Equal).jump(Op::JumpIfNotZero, end);
+      a.jump(Op::Jump, loop);
+      a.bind(end);
+      a.emit(Op::Push, 0).emit(Op::Halt);
+      Program program = a.finish();
+
+      // The output stays in the buffer, and is discarded: there is no descriptor, and the destructor ignores the failure to write to it
+      output::Sink discard(-1);
+      std::int64_t stack[maxStackDepth];
+      std::int64_t locals[localCount] = {};
+      const Instruction* ip = program.instructions().data();
+      handlers[static_cast<std::size_t>(ip->op)](ip, stack, locals, discard);
+
+      return haltFrame;
+    }
+
+    // If every handler jumps to the next, they all run in the frame of the first one, so the program halts at the same depth however many
+    // instructions it ran; any real call leaves a frame behind for each time it runs
+    bool tailCallsAreJumps() {
+      static const bool jumps = haltFrameAfter(1) == haltFrameAfter(100);
+      return jumps;
+    }
+#endif
+
+  }
+
+  Program::Program(std::vector<Instruction> instructions): code(std::move(instructions)) {
+
+    // The stack depth before each instruction, or -1 if it hasn't been reached (yet); every path to an instruction must agree on it
+    std::vector<int> depths(code.size(), -1);
+    std::vector<std::size_t> pending;
+
+    auto reach = [&](std::size_t from, std::ptrdiff_t offset, int depth) {
+      std::ptrdiff_t target = static_cast<std::ptrdiff_t>(from) + offset;
+      if (target < 0 || target >= static_cast<std::ptrdiff_t>(code.size())) {
+        invalid("control leaves the program", from);
+      }
+      int& known = depths[static_cast<std::size_t>(target)];
+      if (known == -1) {
+        known = depth;
+        pending.push_back(static_cast<std::size_t>(target));
+      } else if (known != depth) {
+        invalid("inconsistent stack depth", static_cast<std::size_t>(target));
+      }
+    };
+
+    if (code.empty()) {
+      invalid("no instructions", 0);
+    }
+    reach(0, 0, 0);
+
+    while (!pending.empty()) {
+      std::size_t i = pending.back();
+      pending.pop_back();
+      const Instruction& instruction = code[i];
+
+      if (static_cast<std::size_t>(instruction.op) >= opCount) {
+        invalid("unknown opcode", i);
+      }
+      if ((instruction.op == Op::Load || instruction.op == Op::Store)
+          && (instruction.operand < 0 || static_cast<std::size_t>(instruction.operand) >= localCount)) {
+        invalid("local variable index out of range", i);
+      }
+
+      auto [pops, pushes] = stackEffects[static_cast<std::size_t>(instruction.op)];
+      int depth = depths[i];
+      if (depth < pops) {
+        invalid("stack underflow", i);
+      }
+      depth += pushes - pops;
+      if (depth > static_cast<int>(maxStackDepth)) {
+        invalid("stack overflow", i);
+      }
+
+      switch (instruction.op) {
+        case Op::Halt:
+          break;
+        case Op::Jump:
+          reach(i, instruction.operand, depth);
+          break;
+        case Op::JumpIfZero:
+        case Op::JumpIfNotZero:
+          reach(i, instruction.operand, depth);
+          reach(i, 1, depth);
+          break;
+        default:
+          reach(i, 1, depth);
+      }
+    }
+  }
+
+  Assembler::Label Assembler::label() {
+    labels.push_back(-1);
+    return labels.size() - 1;
+  }
+
+  void Assembler::bind(Label l) {
+    labels.at(l) = static_cast<std::ptrdiff_t>(code.size());
+  }
+
+  Assembler& Assembler::emit(Op op, std::int32_t operand) {
+    code.push_back({op, operand});
+    return *this;
+  }
+
+  Assembler& Assembler::jump(Op op, Label target) {
+    assert(op == Op::Jump || op == Op::JumpIfZero || op == Op::JumpIfNotZero);
+    fixups.emplace_back(code.size(), target);
+    return emit(op);
+  }
+
+  Program Assembler::finish() {
+    for (auto [index, target] : fixups) {
+      if (labels.at(target) < 0) {
+        invalid("jump to an unbound label", index);
+      }
+      code[index].operand = static_cast<std::int32_t>(labels[target] - static_cast<std::ptrdiff_t>(index));
+    }
+    return Program(std::move(code));
+  }
+
+  bool isSupported(Dispatch dispatch) {
+    switch (dispatch) {
+      case Dispatch::Switch:
+        return true;
+      case Dispatch::ComputedGoto:
+#if defined(__GNUC__)
+        return true;
+#else
+        return false;
+#endif
+      default:
+#if defined(BYTECODE_GUARANTEED_TAIL_CALLS)
+        return true;
+#elif defined(BYTECODE_PROBE_TAIL_CALLS)
+        return tailCallsAreJumps();
+#else
+        return false;
+#endif
+    }
+  }
+
+  std::int64_t run(const Program& program, Dispatch dispatch, output::Sink& out) {
+
+    assert(isSupported(dispatch));
+
+    std::int64_t stack[maxStackDepth];
+    std::int64_t locals[localCount] = {};
+    const Instruction* ip = program.instructions().data();
+
+    switch (dispatch) {
+#if defined(__GNUC__)
+      case Dispatch::ComputedGoto:
+        return runComputedGoto(ip, stack, locals, out);
+#endif
+      case Dispatch::TailCall:
+        return handlers[static_cast<std::size_t>(ip->op)](ip, stack, locals, out);
+      default:
+        return runSwitch(ip, stack, locals, out);
+    }
+  }
+
+  Program selectionProgram() {
+
+    constexpr std::int32_t i = 0;
+    constexpr std::int32_t j = 1;
+    Assembler a;
+
+    // int i = 1; if (i != 0) ... else ...
+    auto orElse = a.label();
+    auto endIf = a.label();
+    a.emit(Op::Push, 1).emit(Op::Store, i);
+    a.emit(Op::Load, i).emit(Op::Push, 0).emit(Op::Equal).jump(Op::JumpIfNotZero, orElse);
+    a.emit(Op::Push, 's').emit(Op::Print).jump(Op::Jump, endIf);
+    a.bind(orElse);
+    a.emit(Op::Push, 'f').emit(Op::Print);
+    a.bind(endIf);
+
+    // if (int j = 2 * i; j == 1) ... else if (j == 2) ... else ... (the example's initializer reads the 'i' it declares, which is undefined; here
+    // it reads the outer one)
+    auto elseIf = a.label();
+    auto orElse2 = a.label();
+    auto endIf2 = a.label();
+    a.emit(Op::Push, 2).emit(Op::Load, i).emit(Op::Multiply).emit(Op::Store, j);
+    a.emit(Op::Load, j).emit(Op::Push, 1).emit(Op::Equal).jump(Op::JumpIfZero, elseIf);
+    a.emit(Op::Push, 'a').emit(Op::Print).jump(Op::Jump, endIf2);
+    a.bind(elseIf);
+    a.emit(Op::Load, j).emit(Op::Push, 2).emit(Op::Equal).jump(Op::JumpIfZero, orElse2);
+    a.emit(Op::Push, 'u').emit(Op::Print).jump(Op::Jump, endIf2);
+    a.bind(orElse2);
+    a.emit(Op::Push, 'a').emit(Op::Print);
+    a.bind(endIf2);
+
+    // if constexpr (true): only the taken branch exists
+    a.emit(Op::Push, 'c').emit(Op::Print).emit(Op::Push, 4).emit(Op::Store, i);
+
+    // switch (i): a comparison per case, jumping into case bodies which are laid out in order, so that each falls through into the next unless it
+    // ends with 'break' (a jump past the last one)
+    const char letters[] = {'l', 'u', 'r', 'e', 'c', 'e', 's', 's'};
+    Assembler::Label cases[8];
+    auto endSwitch = a.label();
+    for (std::int32_t c = 0; c < 8; ++c) {
+      cases[c] = a.label();
+      a.emit(Op::Load, i).emit(Op::Push, c).emit(Op::Equal).jump(Op::JumpIfNotZero, cases[c]);
+    }
+    a.jump(Op::Jump, endSwitch);
+    for (std::int32_t c = 0; c < 8; ++c) {
+      a.bind(cases[c]);
+      a.emit(Op::Push, letters[c]).emit(Op::Print);
+      if (c == 3) {
+        a.jump(Op::Jump, endSwitch);
+      }
+    }
+    a.bind(endSwitch);
+
+    a.emit(Op::Push, '\n').emit(Op::Print).emit(Op::Push, 0).emit(Op::Halt);
+    return a.finish();
+  }
+
+  Program jumpProgram() {
+
+    constexpr std::int32_t i = 0;
+    Assembler a;
+
+    // label: switch (i) { case 0: i = 1; break; default: i *= 2; }
+    auto label = a.label();
+    auto otherwise = a.label();
+    auto endSwitch = a.label();
+    a.bind(label);
+    a.emit(Op::Load, i).emit(Op::Push, 0).emit(Op::Equal).jump(Op::JumpIfZero, otherwise);
+    a.emit(Op::Push, 1).emit(Op::Store, i).jump(Op::Jump, endSwitch);
+    a.bind(otherwise);
+    a.emit(Op::Load, i).emit(Op::Push, 2).emit(Op::Multiply).emit(Op::Store, i);
+    a.bind(endSwitch);
+
+    // while (i++ < 5) continue;
+    auto loop = a.label();
+    a.bind(loop);
+    a.emit(Op::Load, i).emit(Op::Load, i).emit(Op::Push, 1).emit(Op::Add).emit(Op::Store, i);
+    a.emit(Op::Push, 5).emit(Op::Less).jump(Op::JumpIfNotZero, loop);
+
+    // if (i < 10) goto label; else return;
+    a.emit(Op::Load, i).emit(Op::Push, 10).emit(Op::Less).jump(Op::JumpIfNotZero, label);
+    a.emit(Op::Load, i).emit(Op::Halt);
+    return a.finish();
+  }
+
+}
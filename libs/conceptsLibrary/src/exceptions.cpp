@@ -1,6 +1,7 @@
 #include <stdexcept>
 
 #include "exceptions.h"
+#include "registry.h"
 
 using namespace exceptionsExample;
 
@@ -69,3 +70,77 @@ void exceptionCatcher() {
   }
   
 }
+
+/**
+ * The same example with errors as values (see "result.h"): each function returns a Result instead of throwing, and each try-block becomes a function
+ * whose caller handles some errors with 'orElse' and passes the rest on.
+ */
+namespace {
+  
+  using results::Result;
+  
+  Result<void, Error> alwaysFails(Colour c) {
+    if (c == red) {
+      return results::fail(Error::logic);
+    } else if (c == blue) {
+      return results::fail(Error::runtime);
+    } else if (c == green) {
+      return results::fail(Error::generic);
+    } else {
+      return results::fail(Error::other);
+    }
+  }
+  
+  // A constructor can only report failure by throwing, so the object is built by a factory which returns a Result. 'transformError' takes the place
+  // of the function-try-block which converts runtime errors into logic errors.
+  struct AlwaysFailsToCreate {
+    
+    static Result<AlwaysFailsToCreate, Error> create(Colour c) {
+      return alwaysFails(c)
+          .transformError([](Error e) { return (e == Error::runtime) ? Error::logic : e; })
+          .transform([] { return AlwaysFailsToCreate(); });
+    }
+  };
+  
+  // The innermost try-block: 'RESULT_TRY' returns the first error, just as the first exception leaves the block
+  Result<void, Error> createAll() {
+    AlwaysFailsToCreate A = RESULT_TRY(AlwaysFailsToCreate::create(red));
+    AlwaysFailsToCreate B = RESULT_TRY(AlwaysFailsToCreate::create(blue));
+    AlwaysFailsToCreate C = RESULT_TRY(AlwaysFailsToCreate::create(green));
+    AlwaysFailsToCreate D = RESULT_TRY(AlwaysFailsToCreate::create(yellow));
+    return {};
+  }
+  
+  // Handles the errors of the innermost block which the innermost catch statement handles, and passes on all others
+  Result<void, Error> innerCatcher() {
+    return createAll().orElse([](Error e) -> Result<void, Error> {
+      if (e == Error::logic) {
+        // This is where red is handled
+        return {};
+      }
+      return results::fail(e);
+    });
+  }
+  
+  Result<void, Error> middleCatcher() {
+    return innerCatcher().orElse([](Error e) -> Result<void, Error> {
+      if (e == Error::generic) {
+        // This is where green is handled; unlike 'catch (const std::exception&)', nothing else matches it by accident
+        return {};
+      }
+      // Passing the error on is explicit, where 'catch (...) { throw; }' is implicit
+      return results::fail(e);
+    });
+  }
+  
+}
+
+void resultCatcher() {
+  
+  // This is where yellow is handled: the equivalent of the outermost 'catch (...)' is ignoring any error
+  static_cast<void>(middleCatcher());
+  
+}
+
+REGISTER_EXAMPLE("concepts/exceptionCatcher", exceptionCatcher);
+REGISTER_EXAMPLE("concepts/resultCatcher", resultCatcher);
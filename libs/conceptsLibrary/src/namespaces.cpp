@@ -1,4 +1,5 @@
 #include "namespaces.h"
+#include "registry.h"
 
 // Functions defined outside of the namespace
 void outerNamespace::f() {}
@@ -26,3 +27,6 @@ void example2() {
   h();
   innerNamespace1::f();
 }
+
+REGISTER_EXAMPLE("concepts/namespaces/example1", example1);
+REGISTER_EXAMPLE("concepts/namespaces/example2", example2);
@@ -0,0 +1,80 @@
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "outputSink.h"
+
+namespace output {
+
+  namespace {
+
+    // Writes all of the given buffers, retrying after partial writes and interruptions
+    void writeAll(int descriptor, iovec* buffers, int count) {
+
+      while (count > 0) {
+        ssize_t written = ::writev(descriptor, buffers, count);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw std::system_error(errno, std::generic_category(), "output::Sink: write failed");
+        }
+
+        auto remaining = static_cast<std::size_t>(written);
+        while (count > 0 && remaining >= buffers->iov_len) {
+          remaining -= buffers->iov_len;
+          ++buffers;
+          --count;
+        }
+        if (count > 0) {
+          buffers->iov_base = static_cast<char*>(buffers->iov_base) + remaining;
+          buffers->iov_len -= remaining;
+        }
+      }
+    }
+
+  }
+
+  Sink::Sink(int descriptor, std::size_t capacity, Flush policy):
+      descriptor(descriptor), buffer(new char[capacity]), capacity(capacity), policy(policy) {
+
+    // 'put' stores into the buffer after draining it, so there must be room for at least one byte
+    if (capacity == 0) {
+      throw std::invalid_argument("output::Sink: the capacity must not be 0");
+    }
+  }
+
+  Sink::~Sink() {
+    try {
+      flush();
+    } catch (const std::system_error&) {
+    }
+  }
+
+  void Sink::drain(std::string_view s) {
+
+    iovec buffers[2] = {{buffer.get(), used}, {const_cast<char*>(s.data()), s.size()}};
+    // Empty the buffer first, so that a failed write doesn't leave the same bytes to be written again by the destructor
+    used = 0;
+
+    // Skip whichever part is empty (e.g. the buffer, when a string larger than the whole buffer is written to an empty sink)
+    iovec* first = buffers[0].iov_len ? buffers : buffers + 1;
+    int count = static_cast<int>((buffers + 1 - first) + (s.empty() ? 0 : 1));
+    writeAll(descriptor, first, count);
+  }
+
+  void Sink::flush() {
+    if (used) {
+      drain();
+    }
+  }
+
+  Sink& standardOutput() {
+    static Sink out(STDOUT_FILENO, Sink::defaultCapacity, Flush::eachLine);
+    return out;
+  }
+
+}
@@ -1,6 +1,14 @@
+#include <cassert>
+#include <cerrno>
 #include <iostream>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
+#include <unistd.h>
+
+#include "bytecode.h"
+#include "registry.h"
 #include "statements.h"
 
 void selectionExample() {
@@ -66,30 +74,30 @@ void selectionExample() {
   std::cout << std::endl;
 }
 
-void iterationExample() {
+void iterationExample(output::Sink& out) {
   
   char cstr[] = "Hello";
   for (int n = 0; char c = cstr[n]; ++n) {
-    std::cout << c;
+    out << c;
   }
   
-  std::cout << ", ";
+  out << ", ";
   
   std::vector<char> v = {'W', 'o', 'r', 'l', 'd'};
   for (const char& c : v) {
-    std::cout << c;
+    out << c;
   }
   
   unsigned short i = 0;
   while (i != 33) {
     i += 1;
   }
-  std::cout << static_cast<char>(i);
+  out << static_cast<char>(i);
   
   do {
     i -= 1;
   } while (i > 10);
-  std::cout << static_cast<char>(i);
+  out << static_cast<char>(i);
 }
 
 void jumpExample() {
@@ -118,3 +126,46 @@ void jumpExample() {
   }
   
 }
+
+void bytecodeExample() {
+
+  using bytecode::Dispatch;
+
+  const bytecode::Program selection = bytecode::selectionProgram();
+  const bytecode::Program jump = bytecode::jumpProgram();
+
+  // The output of the selection program is read back through a pipe, which is large enough to hold it
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    throw std::system_error(errno, std::generic_category(), "bytecodeExample: pipe failed");
+  }
+
+  const char* names[] = {"switch", "computedGoto", "tailCall"};
+  for (Dispatch d : {Dispatch::Switch, Dispatch::ComputedGoto, Dispatch::TailCall}) {
+    if (!bytecode::isSupported(d)) {
+      continue;
+    }
+
+    {
+      output::Sink out(fds[1]);
+      bytecode::run(selection, d, out);
+    }
+    char printed[16];
+    ssize_t size = ::read(fds[0], printed, sizeof(printed));
+    std::string_view selected(printed, (size > 0) ? static_cast<std::size_t>(size) : 0);
+    std::int64_t i = bytecode::run(jump, d);
+
+    std::cout << names[static_cast<int>(d)] << ": " << selected.substr(0, selected.find('\n')) << ", " << i << '\n';
+    assert(selected == "success\n");
+    assert(i == 13);
+  }
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+REGISTER_EXAMPLE("concepts/selectionExample", selectionExample);
+// The default argument isn't part of the function's type, so it's supplied by a lambda
+REGISTER_EXAMPLE("concepts/iterationExample", [] { iterationExample(); });
+REGISTER_EXAMPLE("concepts/jumpExample", jumpExample);
+REGISTER_EXAMPLE("concepts/bytecodeExample", bytecodeExample);
@@ -0,0 +1,254 @@
+#include <climits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "threadPool.h"
+
+namespace concurrency {
+
+  namespace {
+
+    // Identifies the pool and worker running on the current thread, so that tasks submitted by tasks go to the local deque
+    thread_local const void* currentPool = nullptr;
+    thread_local unsigned currentWorker = 0;
+
+    // Number of tasks moved from the injection queue to a worker's deque at once, so that workers don't contend on the injection lock for each task
+    constexpr std::size_t injectionBatch = 32;
+
+    // Number of times a worker looks for work before it parks
+    constexpr int spinRounds = 64;
+
+    std::uint64_t nextRandom(std::uint64_t& state) {
+      // xorshift64
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return state;
+    }
+
+    void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    }
+
+  }
+
+  ThreadPool::Deque::Deque() {
+    buffers.push_back(std::make_unique<Buffer>(1024));
+    buffer.store(buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  void ThreadPool::Deque::push(Task* task) {
+
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_acquire);
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > a->capacity - 1) {
+      auto bigger = std::make_unique<Buffer>(a->capacity * 2);
+      for (std::int64_t i = t; i < b; ++i) {
+        bigger->put(i, a->get(i));
+      }
+
+      a = bigger.get();
+      buffers.push_back(std::move(bigger));
+      buffer.store(a, std::memory_order_release);
+    }
+
+    a->put(b, task);
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  ThreadPool::Task* ThreadPool::Deque::take() {
+
+    std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Task* task = a->get(b);
+    if (t == b) {
+      // Last task: race against thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return task;
+  }
+
+  ThreadPool::Task* ThreadPool::Deque::steal() {
+
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Task* task = buffer.load(std::memory_order_acquire)->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+
+    return task;
+  }
+
+  bool ThreadPool::Deque::empty() const {
+    return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+  }
+
+  ThreadPool::ThreadPool(unsigned threads) {
+
+    threads = threads ? threads : 1;
+
+    for (unsigned i = 0; i < threads; ++i) {
+      workers.push_back(std::make_unique<Worker>());
+      workers.back()->random = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+
+    // Workers may steal from each other as soon as they start, so they are only started once all of them exist
+    for (unsigned i = 0; i < threads; ++i) {
+      workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+
+    stopping.store(true);
+    epoch.fetch_add(1);
+    wake(INT_MAX);
+
+    for (auto& w : workers) {
+      w->thread.join();
+    }
+  }
+
+  void ThreadPool::schedule(Task* task) {
+
+    if (currentPool == this) {
+      workers[currentWorker]->deque.push(task);
+    } else {
+      std::lock_guard<std::mutex> guard(injectionLock);
+      injected.push_back(task);
+      injectedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    epoch.fetch_add(1);
+    if (sleepers.load() > 0) {
+      wake(1);
+    }
+  }
+
+  ThreadPool::Task* ThreadPool::findWork(unsigned self) {
+
+    Worker& me = *workers[self];
+
+    if (Task* task = me.deque.take()) {
+      return task;
+    }
+
+    if (injectedCount.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> guard(injectionLock);
+
+      if (!injected.empty()) {
+        Task* task = injected.front();
+        injected.pop_front();
+
+        // Move a batch into the local deque, where other workers can steal from it
+        std::size_t moved = 1;
+        while (moved < injectionBatch && !injected.empty()) {
+          me.deque.push(injected.front());
+          injected.pop_front();
+          ++moved;
+        }
+
+        injectedCount.fetch_sub(moved, std::memory_order_relaxed);
+        return task;
+      }
+    }
+
+    std::size_t n = workers.size();
+    std::size_t start = nextRandom(me.random) % n;
+    for (std::size_t k = 0; k < n; ++k) {
+      std::size_t victim = (start + k) % n;
+
+      if (victim != self) {
+        if (Task* task = workers[victim]->deque.steal()) {
+          return task;
+        }
+      }
+    }
+
+    return nullptr;
+  }
+
+  void ThreadPool::workerLoop(unsigned self) {
+
+    currentPool = this;
+    currentWorker = self;
+
+    for (;;) {
+      Task* task = nullptr;
+
+      for (int round = 0; round < spinRounds && !task; ++round) {
+        task = findWork(self);
+        if (!task) {
+          cpuRelax();
+        }
+      }
+
+      if (!task) {
+        std::uint32_t observed = epoch.load();
+        sleepers.fetch_add(1);
+
+        task = findWork(self);
+        if (!task) {
+          if (stopping.load()) {
+            sleepers.fetch_sub(1);
+            return;
+          }
+
+          park(observed);
+        }
+
+        sleepers.fetch_sub(1);
+      }
+
+      if (task) {
+        task->run();
+        delete task;
+      }
+    }
+  }
+
+  void ThreadPool::park(std::uint32_t observed) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, observed, nullptr, nullptr, 0);
+#else
+    epoch.wait(observed);
+#endif
+  }
+
+  void ThreadPool::wake(int count) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    (count == 1) ? epoch.notify_one() : epoch.notify_all();
+#endif
+  }
+
+}
@@ -1,9 +1,12 @@
+#include <future>
 #include <iostream>
 #include <stdexcept>
-#include <thread>
 #include <vector>
 
+#include "registry.h"
+#include "threadPool.h"
 #include "threadsafe.h"
+#include "transactional.h"
 
 void synchronizedHelper() {
   
@@ -11,46 +14,53 @@ void synchronizedHelper() {
   // Synchronized blocks are executed under a global lock. Leaving a synchronized block by any means (e.g. reaching the end, jump statement,
   // exception) results in a synchronization with the next block in the total synchronized order. Entering a synchronized block via jump statement
   // is prohibited. A synchronized block can contain any functions.
-  synchronized {
+  stm::synchronized([] {
       std::cout << i << " -> ";
       ++i;
       std::cout << i << '\n';
-  }
+  });
 }
 
 void f() {}
 
+// Spawning and joining an OS thread per task costs far more than the task itself, so the tasks are submitted to a pool of long-lived worker threads
 void synchronizedExample() {
   
-  std::vector<std::thread> v(10);
+  static concurrency::ThreadPool pool;
+  std::vector<std::future<void>> v(10);
   
   for(auto& t: v)
-    t = std::thread([]{ f(); });
+    t = pool.submit([]{ f(); });
   
   for(auto& t: v)
-    t.join();
+    t.get();
 }
 
+// The Transactional Memory TS blocks 'atomic_noexcept', 'atomic_cancel', and 'atomic_commit' are not implemented by GCC, so this example uses their
+// library equivalents from "transactional.h". Shared objects must be accessed through the transaction object.
 void atomicExample(int a, int b, int c) {
 
   static int i = 0, j = 0, k = 0;
   
   // If an exception occurs, abort the transaction and continue stack unwinding.
-  atomic_noexcept {
-    i += a;
-    if (i > 10000) throw std::runtime_error("i too big");
-  }
+  stm::atomicNoexcept([&](stm::Transaction& tx) {
+    tx.store(i, tx.load(i) + a);
+    if (tx.load(i) > 10000) throw std::runtime_error("i too big");
+  });
   
   // If an exception occurs, abort the transaction and continue stack unwinding, unless its one of several approved exceptions which just cancel the
   // transaction.
-  atomic_cancel {
-    j += b;
-    if (j > 10000) throw std::runtime_error("j too big");
-  }
+  stm::atomicCancel<std::runtime_error>([&](stm::Transaction& tx) {
+    tx.store(j, tx.load(j) + b);
+    if (tx.load(j) > 10000) throw std::runtime_error("j too big");
+  });
   
   // If an exception occurs, the transaction commits normally.
-  atomic_commit {
-    k += c;
-    if (k > 10000) throw std::runtime_error("k too big");
-  };
+  stm::atomicCommit([&](stm::Transaction& tx) {
+    tx.store(k, tx.load(k) + c);
+    if (tx.load(k) > 10000) throw std::runtime_error("k too big");
+  });
 }
+
+REGISTER_EXAMPLE("concepts/synchronizedExample", synchronizedExample);
+REGISTER_EXAMPLE("concepts/atomicExample", [] { atomicExample(1, 2, 3); });
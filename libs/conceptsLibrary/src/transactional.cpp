@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#include "transactional.h"
+
+namespace stm {
+
+  namespace {
+
+    // Each lock word holds a version in its upper 63 bits and a "locked" flag in its lowest bit
+    constexpr std::uint64_t lockedBit = 1;
+    constexpr std::uint32_t lockCount = 1 << 20;
+
+    std::atomic<std::uint64_t> globalClock = 0;
+    std::atomic<std::uint64_t> locks[lockCount];
+
+    std::recursive_mutex globalLock;
+
+    std::uint64_t versionOf(std::uint64_t word) {
+      return word >> 1;
+    }
+
+  }
+
+  std::uint32_t Transaction::lockFor(const void* address) {
+    // Fibonacci hashing of the word address spreads neighbouring words across the table
+    auto word = reinterpret_cast<std::uintptr_t>(address) >> 3;
+    return static_cast<std::uint32_t>((word * 0x9E3779B97F4A7C15ull) >> 44);
+  }
+
+  std::uint64_t Transaction::checkLock(std::uint32_t lock) const {
+
+    std::uint64_t word = locks[lock].load(std::memory_order_acquire);
+    if ((word & lockedBit) || versionOf(word) > readVersion) {
+      throw Conflict();
+    }
+
+    return word;
+  }
+
+  void Transaction::validateRead(std::uint32_t lock, std::uint64_t before) {
+
+    // Pairs with the release fence in 'commit': if the read observed a value published by a concurrent commit, this load observes its lock
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (locks[lock].load(std::memory_order_relaxed) != before) {
+      throw Conflict();
+    }
+
+    reads.push_back(lock);
+  }
+
+  void Transaction::begin() {
+    readVersion = globalClock.load(std::memory_order_acquire);
+    writeFilter = 0;
+    reads.clear();
+    writes.clear();
+    acquired.clear();
+  }
+
+  void Transaction::releaseLocks() {
+    for (const Acquired& a : acquired) {
+      locks[a.lock].store(a.previous, std::memory_order_release);
+    }
+    acquired.clear();
+  }
+
+  bool Transaction::commit() {
+
+    // Read-only transactions observed a consistent snapshot at 'readVersion', and need no further validation
+    if (writes.empty()) {
+      return true;
+    }
+
+    // Several written locations may be covered by the same lock
+    for (const Write& w : writes) {
+      if (std::any_of(acquired.begin(), acquired.end(), [&](const Acquired& a) { return a.lock == w.lock; })) {
+        continue;
+      }
+
+      std::uint64_t word = locks[w.lock].load(std::memory_order_relaxed);
+      if ((word & lockedBit) || !locks[w.lock].compare_exchange_strong(word, word | lockedBit, std::memory_order_acquire)) {
+        releaseLocks();
+        return false;
+      }
+      acquired.push_back({w.lock, word});
+    }
+
+    std::uint64_t writeVersion = globalClock.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    // If no other transaction committed since this one began, nothing it read can have changed
+    if (writeVersion != readVersion + 1) {
+      for (std::uint32_t lock : reads) {
+        std::uint64_t word = locks[lock].load(std::memory_order_acquire);
+        auto own = std::find_if(acquired.begin(), acquired.end(), [&](const Acquired& a) { return a.lock == lock; });
+
+        if (own != acquired.end()) {
+          word = own->previous;
+        }
+        if ((word & lockedBit) || versionOf(word) > readVersion) {
+          releaseLocks();
+          return false;
+        }
+      }
+    }
+
+    // Pairs with the acquire fence in 'validateRead'
+    std::atomic_thread_fence(std::memory_order_release);
+    for (const Write& w : writes) {
+      w.publish(w.address, w.value);
+    }
+
+    for (const Acquired& a : acquired) {
+      locks[a.lock].store(writeVersion << 1, std::memory_order_release);
+    }
+    acquired.clear();
+
+    return true;
+  }
+
+  void Transaction::rollback() {
+    releaseLocks();
+    writes.clear();
+  }
+
+  namespace detail {
+
+    Transaction*& current() {
+      thread_local Transaction* tx = nullptr;
+      return tx;
+    }
+
+    Transaction& local() {
+      thread_local Transaction tx;
+      return tx;
+    }
+
+    void backoff(unsigned attempt) {
+
+      if (attempt < 4) {
+        return;
+      }
+
+      if (attempt < 16) {
+        for (unsigned i = 0; i < (1u << attempt); ++i) {
+          std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+        return;
+      }
+
+      std::this_thread::yield();
+    }
+
+  }
+
+  void synchronized(void (*body)(void*), void* context) {
+    std::lock_guard<std::recursive_mutex> guard(globalLock);
+    body(context);
+  }
+
+}
@@ -2,13 +2,17 @@
 #define EXPRESSIONSLIBRARY_H
 
 #include "accessOperators.h"
+#include "arena.h"
 #include "arithmeticOperators.h"
 #include "assignmentOperators.h"
+#include "bulkOperators.h"
 #include "comparisonOperators.h"
 #include "dynamicMemory.h"
 #include "incrementOperators.h"
 #include "literals.h"
 #include "logicalOperators.h"
+#include "numberParser.h"
 #include "otherOperators.h"
+#include "units.h"
 
 #endif // EXPRESSIONSLIBRARY_H
@@ -0,0 +1,154 @@
+#ifndef EXPRESSIONS_ARENA_H
+#define EXPRESSIONS_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * An arena (also known as a "monotonic" or "bump" allocator) hands out memory by incrementing a pointer through large blocks which it obtains from
+ * an upstream memory resource. Individual deallocation is a no-op: memory is reclaimed all at once, either by rewinding the arena to a previously
+ * recorded marker or by resetting it entirely. Blocks are retained across rewinds and resets, so an arena which is reused for similarly sized work
+ * (e.g. per-request allocations) stops touching the upstream resource entirely after the first use.
+ *
+ * Objects created in an arena are never destroyed by it; therefore, only trivially destructible objects may be created directly through 'create'.
+ * The arena is also a 'std::pmr::memory_resource', so that standard containers may allocate from it.
+ *
+ * An arena is not thread-safe.
+ */
+namespace arena {
+
+  class Arena : public std::pmr::memory_resource {
+
+    struct Block {
+      Block* next;
+      std::size_t size;
+      bool owned;
+    };
+
+    Block* head = nullptr;
+    Block* block = nullptr;
+    std::uintptr_t current = 0;
+    std::uintptr_t end = 0;
+    std::size_t blockSize;
+    std::pmr::memory_resource* upstream;
+
+    void* allocateSlow(std::size_t bytes, std::size_t alignment);
+
+    static std::uintptr_t alignUp(std::uintptr_t p, std::size_t alignment) {
+      return (p + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    }
+
+    static std::uintptr_t begin(Block* b) {
+      return reinterpret_cast<std::uintptr_t>(b + 1);
+    }
+
+  protected:
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+      return allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+
+  public:
+
+    // A point in the allocation history of an arena, to which it can later be rewound
+    struct Marker {
+      Block* block;
+      std::uintptr_t current;
+    };
+
+    explicit Arena(std::size_t blockSize = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    // The arena first allocates from the given buffer (e.g. a stack array), and only then from blocks obtained from the upstream resource
+    Arena(void* buffer, std::size_t size, std::size_t blockSize = 64 * 1024,
+          std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    ~Arena() override;
+
+    // Hides 'std::pmr::memory_resource::allocate' so that the common case is inlined at the call site instead of dispatched virtually
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+
+      // 'p' may be past the end of a full block once aligned, and 'p + bytes' may wrap around for huge requests, so the free space is compared
+      // instead. Before the first block, 'p' and 'end' are both 0, and 'p - 1' wraps around, so that even a zero-byte request takes the slow path
+      // and gets a pointer into a block rather than a null pointer.
+      std::uintptr_t p = alignUp(current, alignment);
+      if (p - 1 < end && bytes <= end - p) [[likely]] {
+        current = p + bytes;
+        return reinterpret_cast<void*>(p);
+      }
+
+      return allocateSlow(bytes, alignment);
+    }
+
+    // Allocates uninitialized, suitably aligned storage for 'n' objects of type T; for array types this produces multi-dimensional arrays, e.g.
+    // 'allocateArray<double[5]>(n)' returns a 'double (*)[5]' just like 'new double[n][5]'. Like 'new', throws 'std::bad_array_new_length' if the
+    // size of the array doesn't fit into a 'std::size_t'.
+    template<typename T>
+    T* allocateArray(std::size_t n) {
+      if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        throw std::bad_array_new_length();
+      }
+      return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template<typename T, typename ... Args>
+    T* create(Args&& ... args) {
+      static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+      return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    Marker mark() const {
+      return {block, current};
+    }
+
+    // Reclaims everything allocated since the marker was recorded
+    void rewind(Marker marker);
+
+    // Reclaims everything allocated by the arena, but keeps the blocks for reuse
+    void reset();
+
+    // Reclaims everything allocated by the arena and returns the blocks to the upstream resource
+    void release();
+
+    // Total bytes of storage obtained from the upstream resource
+    std::size_t capacity() const;
+
+  };
+
+  // Rewinds an arena to its current state when the scope ends, reclaiming everything allocated within the scope
+  class Scope {
+
+    Arena& arena;
+    Arena::Marker marker;
+
+  public:
+
+    explicit Scope(Arena& a): arena(a), marker(a.mark()) {}
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope() {
+      arena.rewind(marker);
+    }
+
+  };
+
+}
+
+#endif // EXPRESSIONS_ARENA_H
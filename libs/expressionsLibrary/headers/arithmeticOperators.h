@@ -3,4 +3,6 @@
 
 void arithmeticOperatorsExample();
 
+void bulkOperatorsExample();
+
 #endif // EXPRESSIONS_ARITHMETICOPERATORS_H
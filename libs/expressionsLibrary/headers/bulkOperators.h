@@ -0,0 +1,301 @@
+#ifndef EXPRESSIONS_BULKOPERATORS_H
+#define EXPRESSIONS_BULKOPERATORS_H
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/**
+ * Element-wise application of the arithmetic operators (see "arithmeticOperators.cpp") to whole arrays: 'out[i] = a[i] @ b[i]', 'out[i] = a[i] @ b'
+ * for a single value 'b', or 'out[i] = @a[i]' for the unary operators.
+ *
+ * Each operation has a portable scalar implementation and SSE2, AVX2, and AVX-512 implementations, one of which is chosen at runtime according to
+ * the features of the CPU. The vector implementations are written with GCC vector extensions, so each one is the same loop compiled for a different
+ * instruction set; operations without a native instruction (e.g. integer division, or 8-bit multiplication) are lowered by the compiler.
+ *
+ * All implementations produce the same results as the scalar operators applied to one element at a time, with integer arithmetic wrapping around
+ * like unsigned arithmetic does (also for signed types, whose scalar operators would have undefined behaviour on overflow). As with the scalar
+ * operators, the behaviour is undefined for division by zero, for division of the minimum value of a signed type by -1, and for shift counts which
+ * are negative or not less than the width of the type.
+ *
+ * The output may be one of the inputs, but must not partially overlap them.
+ */
+namespace bulk {
+
+  enum class Isa { Scalar, SSE2, AVX2, AVX512 };
+
+  // The best instruction set supported by this CPU
+  Isa detectedIsa();
+
+  bool isSupported(Isa isa);
+
+  // The instruction set used by all operations; initially 'detectedIsa()', which is detected on the first call to any of these functions
+  Isa activeIsa();
+
+  // Selects the instruction set used by all operations, e.g. to compare implementations; 'isa' must be supported
+  void setActiveIsa(Isa isa);
+
+  enum class Operator { Plus, Minus, Multiplies, Divides, Modulus, Negate, BitNot, BitAnd, BitOr, BitXor, ShiftLeft, ShiftRight };
+
+  template<typename T>
+  concept Element = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float> || std::same_as<T, double>;
+
+  // Floating-point elements only support the operators which the scalar floating-point types support
+  template<Operator Op, typename T>
+  concept Supports = Element<T> && (std::integral<T> || Op == Operator::Plus || Op == Operator::Minus || Op == Operator::Multiplies
+                                    || Op == Operator::Divides || Op == Operator::Negate);
+
+  namespace detail {
+
+    // Integer arithmetic is performed in an unsigned type at least as wide as 'int', so that it wraps around instead of overflowing
+    template<typename T>
+    using Wrapping = typename std::conditional_t<std::is_integral_v<T>,
+                                                 std::conditional_t<(sizeof(T) < sizeof(unsigned)), std::type_identity<unsigned>, std::make_unsigned<T>>,
+                                                 std::type_identity<T>>::type;
+
+    // The same type as 'T', but unsigned if 'T' is an integer
+    template<typename T>
+    using Lane = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::type_identity<T>>::type;
+
+    template<Operator Op, typename T>
+    constexpr T apply(T x, T y) {
+
+      using W = Wrapping<T>;
+
+      if constexpr (Op == Operator::Plus) {
+        return T(W(x) + W(y));
+      } else if constexpr (Op == Operator::Minus) {
+        return T(W(x) - W(y));
+      } else if constexpr (Op == Operator::Multiplies) {
+        return T(W(x) * W(y));
+      } else if constexpr (Op == Operator::Divides) {
+        return T(x / y);
+      } else if constexpr (Op == Operator::Modulus) {
+        return T(x % y);
+      } else if constexpr (Op == Operator::Negate) {
+        return T(-W(x));
+      } else if constexpr (Op == Operator::BitNot) {
+        return T(~x);
+      } else if constexpr (Op == Operator::BitAnd) {
+        return T(x & y);
+      } else if constexpr (Op == Operator::BitOr) {
+        return T(x | y);
+      } else if constexpr (Op == Operator::BitXor) {
+        return T(x ^ y);
+      } else if constexpr (Op == Operator::ShiftLeft) {
+        return T(W(x) << y);
+      } else {
+        return T(x >> y);
+      }
+    }
+
+    // Right-hand operand which is an array
+    template<typename T>
+    struct Elements {
+      const T* p;
+
+      T operator[](std::size_t i) const {
+        return p[i];
+      }
+
+      template<typename V>
+      void load(std::size_t i, V& v) const {
+        std::memcpy(&v, p + i, sizeof(V));
+      }
+    };
+
+    // Right-hand operand which is a single value, applied to every element; also used (and ignored) by the unary operators
+    template<typename T>
+    struct Broadcast {
+      T value;
+
+      T operator[](std::size_t) const {
+        return value;
+      }
+
+      template<typename V>
+      void load(std::size_t, V& v) const {
+        v = V{} + value;
+      }
+    };
+
+    // Computes 'Width' bytes of the output, starting at element 'i'. Vectors are only ever held in local variables, so that this compiles to the
+    // instruction set of the (target-specific) function it is inlined into.
+    template<std::size_t Width, Operator Op, typename T, typename B>
+    [[gnu::always_inline]] inline void step(const T* a, const B& b, T* out, std::size_t i) {
+
+      typedef T V __attribute__((vector_size(Width)));
+      typedef Lane<T> U __attribute__((vector_size(Width)));
+
+      V x, y, r;
+      std::memcpy(&x, a + i, Width);
+      b.load(i, y);
+
+      if constexpr (Op == Operator::Plus) {
+        r = (V) ((U) x + (U) y);
+      } else if constexpr (Op == Operator::Minus) {
+        r = (V) ((U) x - (U) y);
+      } else if constexpr (Op == Operator::Multiplies) {
+        r = (V) ((U) x * (U) y);
+      } else if constexpr (Op == Operator::Divides) {
+        r = x / y;
+      } else if constexpr (Op == Operator::Modulus) {
+        r = x % y;
+      } else if constexpr (Op == Operator::Negate) {
+        r = (V) (-(U) x);
+      } else if constexpr (Op == Operator::BitNot) {
+        r = ~x;
+      } else if constexpr (Op == Operator::BitAnd) {
+        r = x & y;
+      } else if constexpr (Op == Operator::BitOr) {
+        r = x | y;
+      } else if constexpr (Op == Operator::BitXor) {
+        r = x ^ y;
+      } else if constexpr (Op == Operator::ShiftLeft) {
+        r = (V) ((U) x << (U) y);
+      } else {
+        r = x >> y;
+      }
+
+      std::memcpy(out + i, &r, Width);
+    }
+
+    // Four vectors at a time while possible, then one vector at a time, then one element at a time. 'Width' of zero is the scalar implementation.
+    template<std::size_t Width, Operator Op, typename T, typename B>
+    [[gnu::always_inline]] inline void loop(const T* a, const B& b, T* out, std::size_t n) {
+
+      std::size_t i = 0;
+
+      if constexpr (Width > 0) {
+        constexpr std::size_t lanes = Width / sizeof(T);
+
+        for (; i + 4 * lanes <= n; i += 4 * lanes) {
+          step<Width, Op>(a, b, out, i);
+          step<Width, Op>(a, b, out, i + lanes);
+          step<Width, Op>(a, b, out, i + 2 * lanes);
+          step<Width, Op>(a, b, out, i + 3 * lanes);
+        }
+        for (; i + lanes <= n; i += lanes) {
+          step<Width, Op>(a, b, out, i);
+        }
+      }
+
+      for (; i < n; ++i) {
+        out[i] = apply<Op>(a[i], b[i]);
+      }
+    }
+
+    template<Operator Op, typename T, typename B>
+    void scalar(const T* a, B b, T* out, std::size_t n) {
+      loop<0, Op>(a, b, out, n);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    template<Operator Op, typename T, typename B>
+    [[gnu::target("sse2")]] void sse2(const T* a, B b, T* out, std::size_t n) {
+      loop<16, Op>(a, b, out, n);
+    }
+
+    template<Operator Op, typename T, typename B>
+    [[gnu::target("avx2")]] void avx2(const T* a, B b, T* out, std::size_t n) {
+      loop<32, Op>(a, b, out, n);
+    }
+
+    template<Operator Op, typename T, typename B>
+    [[gnu::target("avx512f,avx512bw,avx512dq")]] void avx512(const T* a, B b, T* out, std::size_t n) {
+      loop<64, Op>(a, b, out, n);
+    }
+
+#endif
+
+    template<Operator Op, typename T, typename B>
+    void dispatch(const T* a, B b, T* out, std::size_t n) {
+
+      switch (activeIsa()) {
+#if defined(__x86_64__) || defined(__i386__)
+        case Isa::AVX512:
+          avx512<Op>(a, b, out, n);
+          return;
+        case Isa::AVX2:
+          avx2<Op>(a, b, out, n);
+          return;
+        case Isa::SSE2:
+          sse2<Op>(a, b, out, n);
+          return;
+#endif
+        default:
+          scalar<Op>(a, b, out, n);
+      }
+    }
+
+  }
+
+  template<Operator Op, typename T> requires Supports<Op, T>
+  void apply(std::span<const T> a, std::span<const T> b, std::span<T> out) {
+
+    assert(a.size() == out.size() && b.size() == out.size());
+    detail::dispatch<Op>(a.data(), detail::Elements<T>{b.data()}, out.data(), out.size());
+  }
+
+  template<Operator Op, typename T> requires Supports<Op, T>
+  void apply(std::span<const T> a, std::type_identity_t<T> b, std::span<T> out) {
+
+    assert(a.size() == out.size());
+    detail::dispatch<Op>(a.data(), detail::Broadcast<T>{b}, out.data(), out.size());
+  }
+
+  template<Operator Op, typename T> requires Supports<Op, T>
+  void apply(std::span<const T> a, std::span<T> out) {
+
+    static_assert(Op == Operator::Negate || Op == Operator::BitNot, "Not a unary operator");
+
+    assert(a.size() == out.size());
+    detail::dispatch<Op>(a.data(), detail::Broadcast<T>{T{}}, out.data(), out.size());
+  }
+
+  // Named shorthands for 'apply', e.g. 'bulk::add<int>(a, b, out)'. 'B' is either an array or a single value.
+
+  template<Element T, typename B>
+  void add(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::Plus, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void subtract(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::Minus, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void multiply(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::Multiplies, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void divide(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::Divides, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void modulo(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::Modulus, T>(a, b, out); }
+
+  template<Element T>
+  void negate(std::span<const T> a, std::span<T> out) { apply<Operator::Negate, T>(a, out); }
+
+  template<Element T>
+  void bitNot(std::span<const T> a, std::span<T> out) { apply<Operator::BitNot, T>(a, out); }
+
+  template<Element T, typename B>
+  void bitAnd(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::BitAnd, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void bitOr(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::BitOr, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void bitXor(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::BitXor, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void shiftLeft(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::ShiftLeft, T>(a, b, out); }
+
+  template<Element T, typename B>
+  void shiftRight(std::span<const T> a, const B& b, std::span<T> out) { apply<Operator::ShiftRight, T>(a, b, out); }
+
+}
+
+#endif // EXPRESSIONS_BULKOPERATORS_H
@@ -1,6 +1,10 @@
 #ifndef EXPRESSIONS_DYNAMICMEMORY_H
 #define EXPRESSIONS_DYNAMICMEMORY_H
 
+#include "arena.h"
+
 void dynamicMemoryExample();
 
+void dynamicMemoryArenaExample(arena::Arena& a);
+
 #endif // EXPRESSIONS_DYNAMICMEMORY_H
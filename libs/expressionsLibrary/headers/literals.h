@@ -1,8 +1,11 @@
 #ifndef EXPRESSIONS_LITERALS_H
 #define EXPRESSIONS_LITERALS_H
 
+#include "units.h"
+
 namespace {
-  double operator "" _km(unsigned long long ll) { return (double)ll; }
+  // A user-defined literal which returns a typed quantity ('units::Length', see "units.h") rather than a bare 'double'
+  using units::literals::operator""_km;
 }
 
 void printLiterals();
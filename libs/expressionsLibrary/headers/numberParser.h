@@ -0,0 +1,523 @@
+#ifndef EXPRESSIONS_NUMBERPARSER_H
+#define EXPRESSIONS_NUMBERPARSER_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <iosfwd>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * A runtime parser for the numeric literals of C++ (see "literals.cpp"), written as text:
+ *
+ * - Integers: decimal ('42'), octal ('052'), hexadecimal ('0x2a'), and binary ('0b101010'), with the suffixes 'u', 'l', 'll', and their
+ *   combinations ('1UL', '1llu')
+ * - Floating-point numbers: decimal ('40.0', '.5', '4e1', '1e-3'), and hexadecimal with a binary exponent ('0xa.8p2'), with the suffixes 'f' and 'l'
+ * - Digit separators between any two digits ('1'000'000', '0b1010'0101'), and an optional leading '-', which negates the value in the type of the
+ *   literal, like the unary operator ('-1U' is 4294967295)
+ *
+ * An integer literal gets the first type of its list which can represent it (for decimal literals without 'u', only the signed types), as in C++,
+ * and a literal which no type of its list can represent is out of range. Floating-point literals are correctly rounded to their type (literals with
+ * the suffix 'l' are rounded to 'double'), and a literal whose value is too large for its type, or so small that it rounds to zero, is out of range.
+ *
+ * The parser is built for bulk input, such as large files of numbers separated by whitespace ('parseAll'):
+ * - The length of a run of digits is found 16 characters at a time, by comparing a whole SSE2 register against '0' and '9' and taking the mask of
+ *   the results, instead of testing one character at a time
+ * - Digits are converted 8 at a time (SIMD within a register): 8 characters, already known to be digits, are loaded into a 64-bit integer and
+ *   combined with 3 multiplications instead of 8 dependent multiply-adds; the last 1 to 7 digits are converted the same way, with '0's shifted in
+ *   before them, rather than with a loop whose length varies from number to number (and is therefore mispredicted)
+ * - Floating-point numbers whose significant digits fit into 53 bits, with a small power of 10, are converted exactly with a single multiplication
+ *   or division by an exact power of 10 (the fast path of Clinger's algorithm); all others use 'std::from_chars', which is also exact but slower
+ *
+ * Decimal integers of up to 19 digits and decimal fractions of up to 15 digits, without separators, exponents, or suffixes (the bulk of most
+ * numeric text), take a path which does no other work than the above; all other forms take a slower, general path.
+ * Errors are reported as in 'std::from_chars', with 'std::errc' values, since malformed input is expected, and is handled near the call.
+ */
+namespace numbers {
+
+  enum class Type { Int, UnsignedInt, Long, UnsignedLong, LongLong, UnsignedLongLong, Float, Double, LongDouble };
+
+  struct Number {
+    Type type = Type::Int;
+    // For integers: the value converted to 'unsigned long long', as 'static_cast' would ('-1' is all ones, while '-1U' is 0xFFFFFFFF)
+    std::uint64_t integer = 0;
+    // For floating-point numbers: the value
+    double floating = 0;
+
+    bool isInteger() const {
+      return type < Type::Float;
+    }
+  };
+
+  // Writes the value in its type, e.g. "-1" for '-1' but "4294967295" for '-1U'
+  std::ostream& operator<<(std::ostream& out, const Number& n);
+
+  struct Parsed {
+    // The first character after the literal (or, on error, the position of the error)
+    const char* ptr;
+    // 'invalid_argument' if there is no well-formed literal at the start of the input, 'result_out_of_range' if its value doesn't fit its type
+    std::errc ec;
+  };
+
+  namespace detail {
+
+    inline constexpr std::errc invalid = std::errc::invalid_argument;
+    inline constexpr std::errc outOfRange = std::errc::result_out_of_range;
+
+    constexpr bool isDigit(char c) {
+      return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    // The value of a digit in any base up to 16, or 16 if the character isn't a digit
+    constexpr unsigned digitValue(char c) {
+      if (isDigit(c)) {
+        return static_cast<unsigned>(c - '0');
+      }
+      unsigned letter = static_cast<unsigned char>((c | 0x20) - 'a');
+      return (letter < 6) ? letter + 10 : 16;
+    }
+
+    // Whether 'c' would extend the literal before it (so that e.g. "12x" and "1.5e3.2" are malformed, rather than a literal and some other text)
+    constexpr bool continuesLiteral(char c) {
+      return isDigit(c) || static_cast<unsigned char>((c | 0x20) - 'a') < 26 || c == '_' || c == '.' || c == '\'';
+    }
+
+    // The number of consecutive decimal digits at 'p'
+    inline std::size_t digitRun(const char* p, const char* last) {
+
+      const char* start = p;
+
+#if defined(__SSE2__)
+      typedef unsigned char V __attribute__((vector_size(16)));
+
+      while (last - p >= 16) {
+        V v;
+        std::memcpy(&v, p, 16);
+        // Characters below '0' wrap around to large values, so a single unsigned comparison checks both bounds
+        auto digits = (v - '0') < 10;
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(reinterpret_cast<__m128i>(digits)));
+        if (mask != 0xFFFF) {
+          return static_cast<std::size_t>(p - start) + std::countr_one(mask);
+        }
+        p += 16;
+      }
+#endif
+
+      while (p < last && isDigit(*p)) {
+        ++p;
+      }
+      return static_cast<std::size_t>(p - start);
+    }
+
+    // The value of 8 digits, loaded as a little-endian 64-bit integer: each step combines adjacent pairs of values, so 3 multiplications replace 8
+    inline std::uint32_t parseEight(std::uint64_t chunk) {
+      chunk -= 0x3030303030303030;
+      // 10 * each even digit + the following odd digit, in every other byte
+      chunk = (chunk * 10) + (chunk >> 8);
+      // 100 * pair 0 + pair 1 and 1'000'000 * pair 0 + 10'000 * pair 1 + 100 * pair 2 + pair 3, in the upper half
+      chunk = (((chunk & 0x000000FF000000FF) * (100 + (1'000'000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10'000ULL << 32)))) >> 32;
+      return static_cast<std::uint32_t>(chunk);
+    }
+
+    inline constexpr std::uint64_t powersOf10[] = {1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000,
+                                                   10'000'000'000, 100'000'000'000, 1'000'000'000'000, 10'000'000'000'000, 100'000'000'000'000,
+                                                   1'000'000'000'000'000, 10'000'000'000'000'000, 100'000'000'000'000'000,
+                                                   1'000'000'000'000'000'000, 10'000'000'000'000'000'000ULL};
+
+    // The value of the 'n' decimal digits at 'p', where 'n' is at most 19 (so that the value fits); may read, but ignores, characters up to 'last'
+    inline std::uint64_t parseDigits(const char* p, std::size_t n, const char* last) {
+
+      std::uint64_t value = 0;
+
+      if constexpr (std::endian::native == std::endian::little) {
+        for (; n >= 8; n -= 8, p += 8) {
+          std::uint64_t chunk;
+          std::memcpy(&chunk, p, 8);
+          value = value * 100'000'000 + parseEight(chunk);
+        }
+        // The last 1 to 7 digits are loaded with the characters after them, which are shifted out; '0's are shifted in before the digits, so that
+        // the chunk can be converted like any other (this avoids a loop whose length varies from number to number, and is mispredicted)
+        if (n > 0 && last - p >= 8) {
+          std::uint64_t chunk;
+          std::memcpy(&chunk, p, 8);
+          chunk = (chunk << (8 * (8 - n))) | (0x3030303030303030 >> (8 * n));
+          return value * powersOf10[n] + parseEight(chunk);
+        }
+      }
+
+      for (; n > 0; --n, ++p) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+      }
+      return value;
+    }
+
+    // Scans digits of 'base' from 'p', with single separators between digits; sets 'separators' if there were any
+    inline const char* scanDigits(const char* p, const char* last, unsigned base, bool& separators) {
+
+      const char* start = p;
+      if (base == 10) {
+        p += digitRun(p, last);
+      }
+      while (p < last) {
+        if (digitValue(*p) < base) {
+          ++p;
+        } else if (*p == '\'' && p > start && p + 1 < last && digitValue(p[1]) < base) {
+          separators = true;
+          ++p;
+        } else {
+          break;
+        }
+      }
+      return p;
+    }
+
+    // The first integer type of the literal's list which can represent 'magnitude' (see the C++ standard, [lex.icon]), negated if 'negative'
+    inline std::errc finishInteger(std::uint64_t magnitude, bool decimal, bool isUnsigned, int longs, bool negative, Number& out) {
+
+      constexpr Type types[] = {Type::Int, Type::UnsignedInt, Type::Long, Type::UnsignedLong, Type::LongLong, Type::UnsignedLongLong};
+      constexpr std::uint64_t maxima[] = {std::numeric_limits<int>::max(), std::numeric_limits<unsigned>::max(),
+                                          std::numeric_limits<long>::max(), std::numeric_limits<unsigned long>::max(),
+                                          std::numeric_limits<long long>::max(), std::numeric_limits<unsigned long long>::max()};
+
+      for (int t = 2 * longs; t < 6; ++t) {
+        bool typeIsUnsigned = t % 2;
+        // Decimal literals without 'u' are never unsigned, and literals with 'u' always are
+        if ((isUnsigned && !typeIsUnsigned) || (decimal && !isUnsigned && typeIsUnsigned) || magnitude > maxima[t]) {
+          continue;
+        }
+
+        std::uint64_t value = negative ? (0 - magnitude) : magnitude;
+        out.type = types[t];
+        out.integer = (out.type == Type::UnsignedInt) ? (value & 0xFFFFFFFF) : value;
+        return {};
+      }
+      return outOfRange;
+    }
+
+    // Converts a floating-point literal which doesn't qualify for the fast path, with 'std::from_chars'; 'first' to 'last' is the literal without
+    // its sign, prefix, and suffix (separators are allowed)
+    std::errc slowFloat(const char* first, const char* last, bool hex, Type type, double& value);
+
+    // The powers of 10 which are exactly representable as 'double'
+    inline constexpr double exactPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    inline constexpr float exactPowersFloat[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+
+    // Accumulates the digits of 'base' from 'p' to 'last' (skipping separators) into 'mantissa', ignoring leading zeros; returns false if there
+    // are more significant digits than fit into 64 bits
+    inline bool accumulate(const char* p, const char* last, unsigned base, std::uint64_t& mantissa, int& significant) {
+
+      const int limit = (base == 10) ? 19 : 16;
+      for (; p < last; ++p) {
+        unsigned digit = digitValue(*p);
+        if (*p == '\'' || (mantissa == 0 && digit == 0)) {
+          continue;
+        }
+        if (++significant > limit) {
+          return false;
+        }
+        mantissa = mantissa * base + digit;
+      }
+      return true;
+    }
+
+    // Parses the literal after its sign ('p' is its first digit, or the point); 'digitsEnd' is the end of the run of decimal digits at 'p', if it's
+    // already known
+    inline Parsed parseGeneral(const char* first, const char* p, const char* last, bool negative, Number& out, const char* digitsEnd = nullptr) {
+
+      unsigned base = 10;
+      if (last - p >= 2 && p[0] == '0' && ((p[1] | 0x20) == 'x' || (p[1] | 0x20) == 'b')) {
+        base = ((p[1] | 0x20) == 'x') ? 16 : 2;
+        p += 2;
+      }
+
+      bool separators = false;
+      // The run is only rescanned if it continues after a separator
+      const char* integerEnd = (base == 10 && digitsEnd && (digitsEnd == last || *digitsEnd != '\'')) ? digitsEnd : scanDigits(p, last, base, separators);
+      const char* fractionBegin = integerEnd;
+      const char* fractionEnd = integerEnd;
+      bool point = false;
+      if (base != 2 && integerEnd < last && *integerEnd == '.') {
+        point = true;
+        fractionBegin = integerEnd + 1;
+        fractionEnd = scanDigits(fractionBegin, last, base, separators);
+      }
+
+      if (integerEnd == p && fractionEnd == fractionBegin) {
+        return {first, invalid};
+      }
+
+      // The exponent is a power of 10 for decimal literals, and a power of 2 for hexadecimal ones (where 'e' is a digit)
+      const char* q = fractionEnd;
+      bool exponent = false;
+      long exponentValue = 0;
+      if (base != 2 && q < last && (*q | 0x20) == ((base == 16) ? 'p' : 'e')) {
+        const char* e = q + 1;
+        bool exponentNegative = false;
+        if (e < last && (*e == '+' || *e == '-')) {
+          exponentNegative = (*e == '-');
+          ++e;
+        }
+        bool exponentSeparators = false;
+        const char* exponentEnd = scanDigits(e, last, 10, exponentSeparators);
+        if (exponentEnd == e) {
+          return {q, invalid};
+        }
+        for (const char* d = e; d < exponentEnd; ++d) {
+          // Saturates: any larger exponent overflows (or underflows) anyway
+          if (*d != '\'' && exponentValue < 100'000) {
+            exponentValue = exponentValue * 10 + (*d - '0');
+          }
+        }
+        exponentValue = exponentNegative ? -exponentValue : exponentValue;
+        exponent = true;
+        q = exponentEnd;
+      }
+
+      if (point || exponent) {
+
+        // Hexadecimal floating-point literals always have an exponent, since 'f' is a digit
+        if (base == 16 && !exponent) {
+          return {q, invalid};
+        }
+
+        const char* bodyEnd = q;
+        out.type = Type::Double;
+        if (q < last && (*q | 0x20) == 'f') {
+          out.type = Type::Float;
+          ++q;
+        } else if (q < last && (*q | 0x20) == 'l') {
+          out.type = Type::LongDouble;
+          ++q;
+        }
+        if (q < last && continuesLiteral(*q)) {
+          return {q, invalid};
+        }
+
+        // The digits as an integer, which the fraction digits scale down; 'exact' if all significant digits fit
+        std::uint64_t mantissa = 0;
+        bool exact;
+        long fractionDigits;
+        if (base == 10 && !separators) {
+          // The significant digits are at most two contiguous runs, which are converted 8 at a time
+          const char* integer = p;
+          while (integer < integerEnd && *integer == '0') {
+            ++integer;
+          }
+          const char* fraction = fractionBegin;
+          while (integer == integerEnd && fraction < fractionEnd && *fraction == '0') {
+            ++fraction;
+          }
+          auto integerDigits = static_cast<std::size_t>(integerEnd - integer);
+          auto fractionSignificant = static_cast<std::size_t>(fractionEnd - fraction);
+          exact = integerDigits + fractionSignificant <= 19;
+          if (exact) {
+            mantissa = parseDigits(integer, integerDigits, last) * powersOf10[fractionSignificant] + parseDigits(fraction, fractionSignificant, last);
+          }
+          fractionDigits = fractionEnd - fractionBegin;
+        } else {
+          int significant = 0;
+          exact = accumulate(p, integerEnd, base, mantissa, significant) && accumulate(fractionBegin, fractionEnd, base, mantissa, significant);
+          fractionDigits = 0;
+          for (const char* d = fractionBegin; d < fractionEnd; ++d) {
+            fractionDigits += (*d != '\'');
+          }
+        }
+
+        double value;
+        std::errc ec{};
+        if (exact && mantissa == 0) {
+          value = 0;
+        } else if (base == 16 && exact && mantissa < (1ULL << 53)) {
+          value = std::ldexp(static_cast<double>(mantissa), static_cast<int>(exponentValue - 4 * fractionDigits));
+          if (out.type == Type::Float) {
+            value = static_cast<float>(value);
+          }
+        } else if (long power = exponentValue - fractionDigits; base == 10 && exact && out.type == Type::Float && mantissa <= (1ULL << 24)
+                   && power >= -10 && power <= 10) {
+          float f = static_cast<float>(mantissa);
+          value = (power >= 0) ? f * exactPowersFloat[power] : f / exactPowersFloat[-power];
+        } else if (base == 10 && exact && out.type != Type::Float && mantissa <= (1ULL << 53) && power >= -22 && power <= 22) {
+          double d = static_cast<double>(mantissa);
+          value = (power >= 0) ? d * exactPowers[power] : d / exactPowers[-power];
+        } else {
+          ec = slowFloat(p, bodyEnd, base == 16, out.type, value);
+        }
+
+        // As with 'std::from_chars', a value which rounds to infinity, or a nonzero value which rounds to zero, is out of range
+        double rounded = (out.type == Type::Float) ? static_cast<float>(value) : value;
+        if (ec == std::errc{} && (std::isinf(rounded) || (rounded == 0 && !(exact && mantissa == 0)))) {
+          ec = outOfRange;
+        }
+        if (ec != std::errc{}) {
+          return {first, ec};
+        }
+
+        out.floating = negative ? -value : value;
+        return {q, {}};
+      }
+
+      bool isUnsigned = false;
+      int longs = 0;
+      auto unsignedSuffix = [&] {
+        if (q < last && (*q | 0x20) == 'u') {
+          isUnsigned = true;
+          ++q;
+        }
+      };
+      auto longSuffix = [&] {
+        // 'll' or 'LL', but not 'lL'
+        if (q < last && (*q == 'l' || *q == 'L')) {
+          char l = *q++;
+          longs = 1;
+          if (q < last && *q == l) {
+            longs = 2;
+            ++q;
+          }
+        }
+      };
+      unsignedSuffix();
+      longSuffix();
+      if (!isUnsigned && longs) {
+        unsignedSuffix();
+      }
+      if (q < last && continuesLiteral(*q)) {
+        return {q, invalid};
+      }
+
+      // A decimal literal which starts with '0' is octal ('0' itself included)
+      unsigned digitBase = (base == 10 && *p == '0') ? 8 : base;
+      const unsigned shift = (digitBase == 2) ? 1 : (digitBase == 8) ? 3 : 4;
+
+      std::uint64_t magnitude = 0;
+      if (digitBase == 10 && !separators && integerEnd - p <= 19) {
+        magnitude = parseDigits(p, static_cast<std::size_t>(integerEnd - p), last);
+      } else {
+        for (const char* d = p; d < integerEnd; ++d) {
+          if (*d == '\'') {
+            continue;
+          }
+          unsigned digit = digitValue(*d);
+          if (digit >= digitBase) {
+            return {d, invalid};
+          }
+          if (digitBase == 10) {
+            if (__builtin_mul_overflow(magnitude, 10, &magnitude) || __builtin_add_overflow(magnitude, digit, &magnitude)) {
+              return {first, outOfRange};
+            }
+          } else {
+            if (magnitude >> (64 - shift)) {
+              return {first, outOfRange};
+            }
+            magnitude = (magnitude << shift) | digit;
+          }
+        }
+      }
+
+      std::errc ec = finishInteger(magnitude, digitBase == 10, isUnsigned, longs, negative, out);
+      return {(ec == std::errc{}) ? q : first, ec};
+    }
+
+    constexpr bool isSeparator(char c) {
+      return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',';
+    }
+
+  }
+
+  // Parses the literal at the start of 'first' to 'last', like 'std::from_chars'
+  inline Parsed parse(const char* first, const char* last, Number& out) {
+
+    const char* p = first;
+    bool negative = false;
+    if (p < last && *p == '-') {
+      negative = true;
+      ++p;
+    }
+    if (p == last) {
+      return {first, detail::invalid};
+    }
+
+    // Fast paths for the forms which make up the bulk of most numeric text, without separators, exponents, or suffixes: a decimal integer, or a
+    // decimal fraction, of at most 19 digits ('0' followed by more digits is octal, and is left to the general case)
+    if (detail::isDigit(*p)) {
+      std::size_t n = detail::digitRun(p, last);
+      const char* end = p + n;
+      if (*p == '0' && n > 1) {
+        return detail::parseGeneral(first, p, last, negative, out, end);
+      }
+
+      if (n <= 19 && (end == last || !detail::continuesLiteral(*end))) {
+        std::errc ec = detail::finishInteger(detail::parseDigits(p, n, last), true, false, 0, negative, out);
+        return {(ec == std::errc{}) ? end : first, ec};
+      }
+
+      if (end < last && *end == '.') {
+        std::size_t f = detail::digitRun(end + 1, last);
+        const char* fractionEnd = end + 1 + f;
+        if (n + f <= 19 && (fractionEnd == last || !detail::continuesLiteral(*fractionEnd))) {
+          // Up to 15 digits are exact as a 'double', and so is the quotient, once rounded (larger values can't overflow or underflow either)
+          double value;
+          if (n + f <= 15) {
+            value = static_cast<double>(detail::parseDigits(p, n, last) * detail::powersOf10[f] + detail::parseDigits(end + 1, f, last));
+            value /= detail::exactPowers[f];
+          } else {
+            detail::slowFloat(p, fractionEnd, false, Type::Double, value);
+          }
+          out.type = Type::Double;
+          out.floating = negative ? -value : value;
+          return {fractionEnd, {}};
+        }
+      }
+
+      return detail::parseGeneral(first, p, last, negative, out, end);
+    }
+
+    return detail::parseGeneral(first, p, last, negative, out);
+  }
+
+  // Parses 'text', which must consist of exactly one literal
+  inline std::errc parse(std::string_view text, Number& out) {
+    Parsed r = parse(text.data(), text.data() + text.size(), out);
+    return (r.ec == std::errc{} && r.ptr != text.data() + text.size()) ? detail::invalid : r.ec;
+  }
+
+  // Appends the literals in 'text', separated by whitespace or commas, to 'out'; stops at the first malformed literal
+  inline Parsed parseAll(std::string_view text, std::vector<Number>& out) {
+
+    const char* p = text.data();
+    const char* last = p + text.size();
+
+    while (true) {
+      while (p < last && detail::isSeparator(*p)) {
+        ++p;
+      }
+      if (p == last) {
+        return {p, {}};
+      }
+
+      Number n;
+      Parsed r = parse(p, last, n);
+      if (r.ec != std::errc{}) {
+        return r;
+      }
+      if (r.ptr < last && !detail::isSeparator(*r.ptr)) {
+        return {r.ptr, detail::invalid};
+      }
+      out.push_back(n);
+      p = r.ptr;
+    }
+  }
+
+}
+
+#endif // EXPRESSIONS_NUMBERPARSER_H
@@ -0,0 +1,245 @@
+#ifndef EXPRESSIONS_UNITS_H
+#define EXPRESSIONS_UNITS_H
+
+#include <compare>
+#include <ostream>
+#include <type_traits>
+
+/**
+ * Physical quantities checked at compile time: a 'Quantity' is a 'double' tagged with its dimension (the exponents of length, time, mass, and data),
+ * so that adding a length to a time, or passing a latency where a throughput is expected, is a compile-time error, e.g.
+ *
+ *   using namespace units::literals;
+ *   units::DataRate rate = 64_MiB / 20_ms;
+ *   units::Time latency = 4_KiB / rate;            // A 'Data' here would not compile
+ *   double us = latency.in(units::microsecond);
+ *
+ * Every quantity holds its value in the base unit of its dimension (metres, seconds, kilograms, bytes): units only exist at the boundaries, where
+ * literals and 'value * unit' convert into base units, and 'in(unit)' converts out of them. Both conversions are a multiplication or division by a
+ * constant, which is folded at compile time for literals. In between, a quantity is exactly a 'double': arithmetic on quantities compiles to the
+ * same instructions as arithmetic on doubles, and a quantity is passed and returned in a floating-point register.
+ *
+ * Dimensions are combined by multiplication and division ('Length / Time' is a 'Speed'), and a quantity whose dimensions all cancel out converts to
+ * a 'double' implicitly.
+ */
+namespace units {
+
+  template<int Length, int Time, int Mass, int Data>
+  struct Dimension {
+    static constexpr int length = Length;
+    static constexpr int time = Time;
+    static constexpr int mass = Mass;
+    static constexpr int data = Data;
+  };
+
+  template<typename A, typename B>
+  using Product = Dimension<A::length + B::length, A::time + B::time, A::mass + B::mass, A::data + B::data>;
+
+  template<typename A, typename B>
+  using Quotient = Dimension<A::length - B::length, A::time - B::time, A::mass - B::mass, A::data - B::data>;
+
+  using None = Dimension<0, 0, 0, 0>;
+
+  template<typename D>
+  class Quantity;
+
+  // A unit of dimension 'D': the size of the unit, in base units
+  template<typename D>
+  struct Unit {
+    double factor;
+  };
+
+  template<typename D>
+  class Quantity {
+
+    double value;
+
+    constexpr explicit Quantity(double base): value(base) {}
+
+  public:
+
+    using dimension = D;
+
+    constexpr Quantity() = default;
+
+    constexpr Quantity(double amount, Unit<D> unit): value(amount * unit.factor) {}
+
+    // The value in base units (metres, seconds, kilograms, bytes, and products and quotients of them)
+    static constexpr Quantity fromBase(double base) {
+      return Quantity(base);
+    }
+
+    constexpr double base() const {
+      return value;
+    }
+
+    constexpr double in(Unit<D> unit) const {
+      return value / unit.factor;
+    }
+
+    // Only dimensionless quantities (e.g. a ratio of two times) convert to numbers without naming a unit
+    constexpr operator double() const requires std::is_same_v<D, None> {
+      return value;
+    }
+
+    constexpr Quantity operator+() const { return *this; }
+    constexpr Quantity operator-() const { return Quantity(-value); }
+
+    constexpr Quantity& operator+=(Quantity other) { value += other.value; return *this; }
+    constexpr Quantity& operator-=(Quantity other) { value -= other.value; return *this; }
+    constexpr Quantity& operator*=(double scale) { value *= scale; return *this; }
+    constexpr Quantity& operator/=(double scale) { value /= scale; return *this; }
+
+    friend constexpr Quantity operator+(Quantity a, Quantity b) { return Quantity(a.value + b.value); }
+    friend constexpr Quantity operator-(Quantity a, Quantity b) { return Quantity(a.value - b.value); }
+    friend constexpr Quantity operator*(Quantity a, double scale) { return Quantity(a.value * scale); }
+    friend constexpr Quantity operator*(double scale, Quantity a) { return Quantity(scale * a.value); }
+    friend constexpr Quantity operator/(Quantity a, double scale) { return Quantity(a.value / scale); }
+
+    friend constexpr Quantity<Quotient<None, D>> operator/(double scale, Quantity a) {
+      return Quantity<Quotient<None, D>>::fromBase(scale / a.value);
+    }
+
+    template<typename E>
+    friend constexpr Quantity<Product<D, E>> operator*(Quantity a, Quantity<E> b) {
+      return Quantity<Product<D, E>>::fromBase(a.value * b.base());
+    }
+
+    template<typename E>
+    friend constexpr Quantity<Quotient<D, E>> operator/(Quantity a, Quantity<E> b) {
+      return Quantity<Quotient<D, E>>::fromBase(a.value / b.base());
+    }
+
+    friend constexpr bool operator==(Quantity, Quantity) = default;
+    friend constexpr auto operator<=>(Quantity, Quantity) = default;
+
+  };
+
+  // '3 * units::kilometre'
+  template<typename D>
+  constexpr Quantity<D> operator*(double amount, Unit<D> unit) {
+    return Quantity<D>(amount, unit);
+  }
+
+  // Units of compound dimensions, e.g. 'units::mebibyte / units::second'
+  template<typename A, typename B>
+  constexpr Unit<Quotient<A, B>> operator/(Unit<A> a, Unit<B> b) {
+    return {a.factor / b.factor};
+  }
+
+  template<typename A, typename B>
+  constexpr Unit<Product<A, B>> operator*(Unit<A> a, Unit<B> b) {
+    return {a.factor * b.factor};
+  }
+
+  using Length = Quantity<Dimension<1, 0, 0, 0>>;
+  using Time = Quantity<Dimension<0, 1, 0, 0>>;
+  using Mass = Quantity<Dimension<0, 0, 1, 0>>;
+  using Data = Quantity<Dimension<0, 0, 0, 1>>;
+  using Speed = Quantity<Dimension<1, -1, 0, 0>>;
+  using Frequency = Quantity<Dimension<0, -1, 0, 0>>;
+  using DataRate = Quantity<Dimension<0, -1, 0, 1>>;
+  using Dimensionless = Quantity<None>;
+
+  // A quantity has the size, alignment, and triviality of a 'double', so it's passed and stored exactly like one
+  static_assert(sizeof(DataRate) == sizeof(double) && alignof(DataRate) == alignof(double));
+  static_assert(std::is_trivially_copyable_v<DataRate> && std::is_standard_layout_v<DataRate>);
+
+  inline constexpr Unit<Length::dimension> metre{1};
+  inline constexpr Unit<Length::dimension> kilometre{1e3};
+  inline constexpr Unit<Length::dimension> centimetre{1e-2};
+  inline constexpr Unit<Length::dimension> millimetre{1e-3};
+
+  inline constexpr Unit<Time::dimension> second{1};
+  inline constexpr Unit<Time::dimension> millisecond{1e-3};
+  inline constexpr Unit<Time::dimension> microsecond{1e-6};
+  inline constexpr Unit<Time::dimension> nanosecond{1e-9};
+  inline constexpr Unit<Time::dimension> minute{60};
+  inline constexpr Unit<Time::dimension> hour{3600};
+
+  inline constexpr Unit<Mass::dimension> kilogram{1};
+  inline constexpr Unit<Mass::dimension> gram{1e-3};
+
+  inline constexpr Unit<Data::dimension> bit{0.125};
+  inline constexpr Unit<Data::dimension> byte{1};
+  inline constexpr Unit<Data::dimension> kilobyte{1e3};
+  inline constexpr Unit<Data::dimension> megabyte{1e6};
+  inline constexpr Unit<Data::dimension> gigabyte{1e9};
+  inline constexpr Unit<Data::dimension> kibibyte{1024.0};
+  inline constexpr Unit<Data::dimension> mebibyte{1024.0 * 1024};
+  inline constexpr Unit<Data::dimension> gibibyte{1024.0 * 1024 * 1024};
+
+  inline constexpr Unit<Frequency::dimension> hertz{1};
+
+  // Writes the value in base units, followed by the base units, e.g. "2.5e+06 B/s"
+  template<typename D>
+  std::ostream& operator<<(std::ostream& out, Quantity<D> q) {
+
+    const char* symbols[] = {"m", "s", "kg", "B"};
+    const int exponents[] = {D::length, D::time, D::mass, D::data};
+
+    out << q.base();
+
+    bool numerator = false;
+    for (int i = 0; i < 4; ++i) {
+      if (exponents[i] > 0) {
+        out << (numerator ? "*" : " ") << symbols[i];
+        if (exponents[i] > 1) {
+          out << '^' << exponents[i];
+        }
+        numerator = true;
+      }
+    }
+
+    for (int i = 0; i < 4; ++i) {
+      if (exponents[i] < 0) {
+        out << (numerator ? "/" : " 1/") << symbols[i];
+        if (exponents[i] < -1) {
+          out << '^' << -exponents[i];
+        }
+        numerator = true;
+      }
+    }
+
+    return out;
+  }
+
+  namespace literals {
+
+#define UNITS_LITERAL(suffix, unit)                                                                                                        \
+    constexpr auto operator""_##suffix(long double amount) { return static_cast<double>(amount) * (unit); }                                \
+    constexpr auto operator""_##suffix(unsigned long long amount) { return static_cast<double>(amount) * (unit); }
+
+    UNITS_LITERAL(m, metre)
+    UNITS_LITERAL(km, kilometre)
+    UNITS_LITERAL(cm, centimetre)
+    UNITS_LITERAL(mm, millimetre)
+
+    UNITS_LITERAL(s, second)
+    UNITS_LITERAL(ms, millisecond)
+    UNITS_LITERAL(us, microsecond)
+    UNITS_LITERAL(ns, nanosecond)
+    UNITS_LITERAL(min, minute)
+    UNITS_LITERAL(h, hour)
+
+    UNITS_LITERAL(kg, kilogram)
+    UNITS_LITERAL(g, gram)
+
+    UNITS_LITERAL(bit, bit)
+    UNITS_LITERAL(B, byte)
+    UNITS_LITERAL(KB, kilobyte)
+    UNITS_LITERAL(MB, megabyte)
+    UNITS_LITERAL(GB, gigabyte)
+    UNITS_LITERAL(KiB, kibibyte)
+    UNITS_LITERAL(MiB, mebibyte)
+    UNITS_LITERAL(GiB, gibibyte)
+
+    UNITS_LITERAL(Hz, hertz)
+
+#undef UNITS_LITERAL
+
+  }
+
+}
+
+#endif // EXPRESSIONS_UNITS_H
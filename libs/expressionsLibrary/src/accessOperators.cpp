@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "accessOperators.h"
+#include "registry.h"
 
 void accessOperatorsExample() {
   
@@ -18,3 +19,5 @@ void accessOperatorsExample() {
   assert(r[0] == r[1]);
 
 }
+
+REGISTER_EXAMPLE("expressions/accessOperatorsExample", accessOperatorsExample);
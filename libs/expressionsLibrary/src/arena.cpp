@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#include "arena.h"
+
+namespace arena {
+  
+  Arena::Arena(std::size_t blockSize, std::pmr::memory_resource* upstream): blockSize(blockSize), upstream(upstream) {}
+  
+  Arena::Arena(void* buffer, std::size_t size, std::size_t blockSize, std::pmr::memory_resource* upstream): Arena(blockSize, upstream) {
+    
+    auto first = reinterpret_cast<std::uintptr_t>(buffer);
+    auto aligned = alignUp(first, alignof(Block));
+    
+    if (aligned + sizeof(Block) < first + size) {
+      head = ::new (reinterpret_cast<void*>(aligned)) Block{nullptr, (first + size) - (aligned + sizeof(Block)), false};
+    }
+  }
+  
+  Arena::~Arena() {
+    release();
+  }
+  
+  void* Arena::allocateSlow(std::size_t bytes, std::size_t alignment) {
+    
+    // Worst case, the start of a block must be padded up to the requested alignment; a request so large that the block size would wrap around can
+    // never be satisfied
+    if (bytes > std::numeric_limits<std::size_t>::max() - sizeof(Block) - alignment) {
+      throw std::bad_alloc();
+    }
+    std::size_t needed = bytes + alignment;
+    Block* next = block ? block->next : head;
+    
+    // Blocks retained from before a rewind or reset are reused if they are large enough; otherwise a new block is inserted in front of them, so that
+    // they remain available to later allocations
+    if (!next || next->size < needed) {
+      std::size_t size = std::max(blockSize, needed);
+      Block* fresh = ::new (upstream->allocate(sizeof(Block) + size, alignof(std::max_align_t))) Block{next, size, true};
+      
+      if (block) {
+        block->next = fresh;
+      } else {
+        head = fresh;
+      }
+      next = fresh;
+    }
+    
+    block = next;
+    end = begin(block) + block->size;
+    
+    std::uintptr_t p = alignUp(begin(block), alignment);
+    current = p + bytes;
+    return reinterpret_cast<void*>(p);
+  }
+  
+  void Arena::rewind(Marker marker) {
+    block = marker.block;
+    current = marker.current;
+    end = block ? begin(block) + block->size : 0;
+  }
+  
+  void Arena::reset() {
+    rewind({nullptr, 0});
+  }
+  
+  void Arena::release() {
+    
+    Block* kept = nullptr;
+    
+    for (Block* b = head; b;) {
+      Block* next = b->next;
+      
+      if (b->owned) {
+        upstream->deallocate(b, sizeof(Block) + b->size, alignof(std::max_align_t));
+      } else {
+        kept = b;
+        kept->next = nullptr;
+      }
+      
+      b = next;
+    }
+    
+    head = kept;
+    reset();
+  }
+  
+  std::size_t Arena::capacity() const {
+    
+    std::size_t total = 0;
+    for (Block* b = head; b; b = b->next) {
+      if (b->owned) {
+        total += b->size;
+      }
+    }
+    
+    return total;
+  }
+  
+}
@@ -1,6 +1,12 @@
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 #include "arithmeticOperators.h"
+#include "bulkOperators.h"
+#include "registry.h"
 
 void arithmeticOperatorsExample() {
   
@@ -9,7 +15,8 @@ void arithmeticOperatorsExample() {
   int a = 1;
   int b = -1;
   int c = 3;
-  int d;
+  // Only read by assertions
+  [[maybe_unused]] int d;
   
   d = +a;
   assert(d == a);
@@ -32,7 +39,7 @@ void arithmeticOperatorsExample() {
   d = c % 2;
   assert(d == 1);
   
-  d = ~85;
+  d = (unsigned char)(~i);
   assert(d == j);
   
   d = i & j;
@@ -51,3 +58,116 @@ void arithmeticOperatorsExample() {
   assert(d == 1);
 
 }
+
+namespace {
+  
+  // Long enough to exercise the unrolled, single-vector, and scalar parts of every implementation
+  constexpr std::size_t length = 1027;
+  
+  // The arguments are unused when assertions are disabled
+  template<typename T>
+  void assertAll([[maybe_unused]] const std::vector<T>& v, [[maybe_unused]] T expected) {
+    assert(std::ranges::all_of(v, [&](T x) { return x == expected; }));
+  }
+  
+  // The operations of 'arithmeticOperatorsExample', applied to every element of an array. Each result must equal that of the scalar operator, which
+  // for signed types are the values asserted by 'arithmeticOperatorsExample'.
+  template<typename T>
+  void bulkArithmetic() {
+    
+    const T x = 1;
+    const T y = T(-1);
+    const T z = 3;
+    
+    std::vector<T> a(length, x);
+    std::vector<T> b(length, y);
+    std::vector<T> c(length, z);
+    std::vector<T> d(length);
+    
+    bulk::negate<T>(b, d);
+    assertAll(d, T(-y));
+    
+    bulk::add<T>(a, b, d);
+    assertAll(d, T(x + y));
+    
+    bulk::subtract<T>(a, b, d);
+    assertAll(d, T(x - y));
+    
+    bulk::multiply<T>(c, a, d);
+    assertAll(d, T(z * x));
+    
+    bulk::divide<T>(c, b, d);
+    assertAll(d, T(z / y));
+    
+    if constexpr (std::is_integral_v<T>) {
+      bulk::modulo<T>(c, 2, d);
+      assertAll(d, T(z % 2));
+      
+      bulk::shiftLeft<T>(c, a, d);
+      assertAll(d, T(z << x));
+      
+      bulk::shiftRight<T>(c, a, d);
+      assertAll(d, T(z >> x));
+      
+      // Arithmetic wraps around, for signed and unsigned types alike
+      std::vector<T> max(length, std::numeric_limits<T>::max());
+      
+      bulk::add<T>(max, 1, d);
+      assertAll(d, std::numeric_limits<T>::min());
+    }
+  }
+  
+  template<typename T>
+  void bulkBitwise() {
+    
+    std::vector<T> i(length, T(85));
+    std::vector<T> j(length, T(170));
+    std::vector<T> d(length);
+    
+    bulk::bitNot<T>(i, d);
+    assertAll(d, T(~T(85)));
+    
+    bulk::bitAnd<T>(i, j, d);
+    assertAll(d, T(0));
+    
+    bulk::bitOr<T>(i, j, d);
+    assertAll(d, T(255));
+    
+    bulk::bitXor<T>(i, 255, d);
+    assertAll(d, T(170));
+  }
+  
+}
+
+void bulkOperatorsExample() {
+  
+  bulk::Isa detected = bulk::detectedIsa();
+  
+  for (bulk::Isa isa : {bulk::Isa::Scalar, bulk::Isa::SSE2, bulk::Isa::AVX2, bulk::Isa::AVX512}) {
+    if (!bulk::isSupported(isa)) {
+      continue;
+    }
+    bulk::setActiveIsa(isa);
+    
+    bulkArithmetic<std::int8_t>();
+    bulkArithmetic<std::uint8_t>();
+    bulkArithmetic<std::int16_t>();
+    bulkArithmetic<std::uint16_t>();
+    bulkArithmetic<std::int32_t>();
+    bulkArithmetic<std::uint32_t>();
+    bulkArithmetic<std::int64_t>();
+    bulkArithmetic<std::uint64_t>();
+    bulkArithmetic<float>();
+    bulkArithmetic<double>();
+    
+    bulkBitwise<std::uint8_t>();
+    bulkBitwise<std::int16_t>();
+    bulkBitwise<std::uint32_t>();
+    bulkBitwise<std::int64_t>();
+  }
+  
+  bulk::setActiveIsa(detected);
+}
+
+REGISTER_EXAMPLE("expressions/arithmeticOperatorsExample", arithmeticOperatorsExample);
+REGISTER_EXAMPLE("expressions/bulkOperatorsExample", bulkOperatorsExample);
@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "assignmentOperators.h"
+#include "registry.h"
 
 void assignmentOperatorsExample() {
 
@@ -53,3 +54,5 @@ void assignmentOperatorsExample() {
   assert(a == 0);
   
 }
+
+REGISTER_EXAMPLE("expressions/assignmentOperatorsExample", assignmentOperatorsExample);
@@ -0,0 +1,63 @@
+#include <atomic>
+
+#include "bulkOperators.h"
+#include "platform.h"
+
+namespace bulk {
+
+  namespace {
+
+    Isa detect() {
+
+#if defined(__x86_64__) || defined(__i386__)
+      const platform::Features& f = platform::features();
+
+      // The AVX-512 implementations also use the byte/word (BW) and doubleword/quadword (DQ) extensions, e.g. for 64-bit multiplication, and the
+      // kernels of 'PackedIntArray' use the vector length (VL) extension to convert between bytes and 64-bit lanes in narrower registers
+      if (f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl) {
+        return Isa::AVX512;
+      }
+      if (f.avx2) {
+        return Isa::AVX2;
+      }
+      if (f.sse2) {
+        return Isa::SSE2;
+      }
+#endif
+
+      return Isa::Scalar;
+    }
+
+    // Not an instruction set: 'active' holds it until the first call to 'activeIsa' or 'setActiveIsa', so that nothing is detected before 'main'
+    constexpr Isa unset = static_cast<Isa>(-1);
+
+    constinit std::atomic<Isa> active = unset;
+
+  }
+
+  Isa detectedIsa() {
+    static const Isa detected = detect();
+    return detected;
+  }
+
+  bool isSupported(Isa isa) {
+    return isa <= detectedIsa();
+  }
+
+  Isa activeIsa() {
+    Isa isa = active.load(std::memory_order_relaxed);
+    if (isa == unset) [[unlikely]] {
+      // Unless another thread has set it in the meantime, in which case 'isa' becomes its choice
+      if (active.compare_exchange_strong(isa, detectedIsa(), std::memory_order_relaxed)) {
+        isa = detectedIsa();
+      }
+    }
+    return isa;
+  }
+
+  void setActiveIsa(Isa isa) {
+    assert(isSupported(isa));
+    active.store(isa, std::memory_order_relaxed);
+  }
+
+}
@@ -2,6 +2,7 @@
 #include <compare>
 
 #include "comparisonOperators.h"
+#include "registry.h"
 
 void comparisonOperatorsExample() {
 
@@ -25,3 +26,5 @@ void comparisonOperatorsExample() {
   assert((a <=> a) == 0);
   
 }
+
+REGISTER_EXAMPLE("expressions/comparisonOperatorsExample", comparisonOperatorsExample);
@@ -1,4 +1,7 @@
+#include <vector>
+
 #include "dynamicMemory.h"
+#include "registry.h"
 
 /**
  * The 'new' expression creates and initializes objects with dynamic storage duration (i.e. objects whose storage duration is not limited by the
@@ -45,3 +48,27 @@ void dynamicMemoryExample() {
   delete[] matrix;
   
 }
+
+/**
+ * The same allocations as above, performed in an arena. Each allocation is a pointer increment into memory which the arena already owns, and there
+ * is no need to delete anything individually: everything allocated within the scope is reclaimed at once when the scope ends.
+ */
+void dynamicMemoryArenaExample(arena::Arena& a) {
+  
+  arena::Scope scope(a);
+  
+  // Uninitialized storage for an array of 10 function pointers, equivalent to 'new (int(*[10])())'
+  a.allocateArray<int(*)()>(10);
+  
+  // Constructs a single object, equivalent to 'new auto(42)'
+  int* p = a.create<int>(42);
+  
+  // The first dimension of an array can still be specified at runtime; the result is a 'double (*)[5]'
+  a.allocateArray<double[5]>(*p);
+  
+  // Standard containers can allocate from the arena through the polymorphic allocator interface
+  std::pmr::vector<double> v(*p, 0.0, &a);
+  
+}
+
+REGISTER_EXAMPLE("expressions/dynamicMemoryExample", dynamicMemoryExample);
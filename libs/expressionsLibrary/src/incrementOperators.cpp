@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "incrementOperators.h"
+#include "registry.h"
 
 void incrementOperatorsExample() {
 
@@ -23,3 +24,5 @@ void incrementOperatorsExample() {
   assert(a == 1);
 
 }
+
+REGISTER_EXAMPLE("expressions/incrementOperatorsExample", incrementOperatorsExample);
@@ -1,41 +1,58 @@
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
+#include <string_view>
 
 #include "literals.h"
+#include "numberParser.h"
+#include "registry.h"
 
 void printLiterals() {
   
+  // Each line ends with '\n' rather than 'std::endl', which would also flush the stream (a system call) after every line
+  
   // Boolean literals
-  std::cout << true << std::endl;
-  std::cout << false << std::endl;
+  std::cout << true << '\n';
+  std::cout << false << '\n';
   
   // Character literals
-  std::cout << 'a' << std::endl; // regular character
-  std::cout << reinterpret_cast<const char*>(u8'a')<< std::endl; // UTF- 8 character
-  std::cout << reinterpret_cast<const char*>(u'貓') << std::endl; // UTF-16 character
-  std::cout << reinterpret_cast<const char*>(U'🍌') << std::endl; // UTF-32 character
-  std::cout << reinterpret_cast<const char*>(L'β') << std::endl; // wide character
+  std::cout << 'a' << '\n'; // regular character
+  // Streams can't print the other character types (their operators are deleted since C++20), so these print their code points
+  std::cout << static_cast<std::uint32_t>(u8'a') << '\n'; // UTF- 8 character
+  std::cout << static_cast<std::uint32_t>(u'貓') << '\n'; // UTF-16 character
+  std::cout << static_cast<std::uint32_t>(U'🍌') << '\n'; // UTF-32 character
+  std::cout << static_cast<std::uint32_t>(L'β') << '\n'; // wide character
   
   // Integer literals
-  std::cout << 42 << std::endl; // decimal integer
-  std::cout << 052 << std::endl; // octal integer
-  std::cout << 0x2a << std::endl; // hexadecimal integer
-  std::cout << 0b101010 << std::endl; // binary integer
+  std::cout << 42 << '\n'; // decimal integer
+  std::cout << 052 << '\n'; // octal integer
+  std::cout << 0x2a << '\n'; // hexadecimal integer
+  std::cout << 0b101010 << '\n'; // binary integer
   
-  std::cout << 1 << std::endl; // signed integer
-  std::cout << 1U << std::endl; // unsigned integer
-  std::cout << 1L << std::endl; // signed long integer
-  std::cout << 1UL << std::endl; // unsigned long integer
-  std::cout << -1UL << std::endl; // same as above; there are no negative integer literals, only positive ones sent as input to unary '-'
+  std::cout << 1 << '\n'; // signed integer
+  std::cout << 1U << '\n'; // unsigned integer
+  std::cout << 1L << '\n'; // signed long integer
+  std::cout << 1UL << '\n'; // unsigned long integer
+  std::cout << -1UL << '\n'; // same as above; there are no negative integer literals, only positive ones sent as input to unary '-'
   
   // Floating-point literals
-  std::cout << 40.0 << std::endl; // floating-point number
-  std::cout << 4e1 << std::endl; // same as above, expressed differently
-  std::cout << 0xa.8p2 << std::endl; // same as above, expressed as hex floating point: a=10; 8=0.5 (since 16 * 0.5 = 8); 2^2=4; 10.5 * 4 = 42
+  std::cout << 40.0 << '\n'; // floating-point number
+  std::cout << 4e1 << '\n'; // same as above, expressed differently
+  std::cout << 0xa.8p2 << '\n'; // same as above, expressed as hex floating point: a=10; 8=0.5 (since 16 * 0.5 = 8); 2^2=4; 10.5 * 4 = 42
   
   // String literals
-  std::cout << "Hello, world!" << std::endl;
+  std::cout << "Hello, world!" << '\n';
   
   // User-defined literals
-  std::cout << 12_km << std::endl;
+  std::cout << 12_km << '\n';
+  
+  // The same numeric literals, written as text and parsed at runtime, with the same types and values as the compiler gives them
+  for (std::string_view text : {"42", "052", "0x2a", "0b101010", "1UL", "-1UL", "40.0", "4e1", "0xa.8p2"}) {
+    numbers::Number number;
+    numbers::parse(text, number);
+    std::cout << text << " = " << number << '\n';
+  }
   
 }
+
+REGISTER_EXAMPLE("expressions/printLiterals", printLiterals);
@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "logicalOperators.h"
+#include "registry.h"
 
 void logicalOperatorsExample() {
   
@@ -19,3 +20,5 @@ void logicalOperatorsExample() {
   assert(!(f || f));
   
 }
+
+REGISTER_EXAMPLE("expressions/logicalOperatorsExample", logicalOperatorsExample);
@@ -0,0 +1,63 @@
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include "numberParser.h"
+
+namespace numbers {
+
+  namespace detail {
+
+    std::errc slowFloat(const char* first, const char* last, bool hex, Type type, double& value) {
+
+      // 'std::from_chars' doesn't accept separators, so they are removed from a copy (only if there are any, since they are rare)
+      std::string clean;
+      const char* begin = first;
+      const char* end = last;
+      if (std::memchr(first, '\'', static_cast<std::size_t>(last - first))) {
+        clean.reserve(static_cast<std::size_t>(last - first));
+        for (const char* p = first; p < last; ++p) {
+          if (*p != '\'') {
+            clean += *p;
+          }
+        }
+        begin = clean.data();
+        end = begin + clean.size();
+      }
+
+      const std::chars_format format = hex ? std::chars_format::hex : std::chars_format::general;
+
+      std::from_chars_result result;
+      if (type == Type::Float) {
+        float f = 0;
+        result = std::from_chars(begin, end, f, format);
+        value = f;
+      } else {
+        result = std::from_chars(begin, end, value, format);
+      }
+
+      if (result.ec == std::errc{} && result.ptr != end) {
+        return invalid;
+      }
+      return result.ec;
+    }
+
+  }
+
+  std::ostream& operator<<(std::ostream& out, const Number& n) {
+    switch (n.type) {
+      case Type::Int:
+      case Type::Long:
+      case Type::LongLong:
+        return out << static_cast<long long>(n.integer);
+      case Type::UnsignedInt:
+      case Type::UnsignedLong:
+      case Type::UnsignedLongLong:
+        return out << n.integer;
+      default:
+        return out << n.floating;
+    }
+  }
+
+}
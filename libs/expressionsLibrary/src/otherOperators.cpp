@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "otherOperators.h"
+#include "registry.h"
 
 void otherOperatorsExample() {
 
@@ -19,5 +20,7 @@ void otherOperatorsExample() {
   
   assert(alignof(char) == 1);
 
-  assert(!noexcept(otherOperatorsExample));
+  assert(!noexcept(otherOperatorsExample()));
 }
+
+REGISTER_EXAMPLE("expressions/otherOperatorsExample", otherOperatorsExample);
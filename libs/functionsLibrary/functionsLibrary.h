@@ -2,6 +2,7 @@
 #define FUNCTIONSLIBRARY_H
 
 #include "fdeclarations.h"
+#include "inplaceFunction.h"
 #include "lambda.h"
 
 #endif // FUNCTIONSLIBRARY_H
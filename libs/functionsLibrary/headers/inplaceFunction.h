@@ -0,0 +1,295 @@
+#ifndef FUNCTIONS_INPLACEFUNCTION_H
+#define FUNCTIONS_INPLACEFUNCTION_H
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Type-erased callables which never allocate.
+ *
+ * 'std::function' stores small callables (in libstdc++, trivially copyable ones of up to 16 bytes) inside itself and all others on the heap, so
+ * storing a closure with a few captures costs an allocation. 'InplaceFunction<R(Args...), Capacity>' always stores the callable in an inline buffer
+ * of 'Capacity' bytes: a callable which doesn't fit is a compile-time error, rather than a silent allocation.
+ *
+ * - 'InplaceFunction' is copyable, and so requires copyable callables, like 'std::function'
+ * - 'InplaceMoveOnlyFunction' is move-only, and also accepts move-only callables (e.g. closures which own a 'std::unique_ptr')
+ * - 'FunctionRef' doesn't store the callable at all, but refers to it: it is two pointers, trivially copyable, and the cheapest way to pass a
+ *   callable to a function which calls it before returning, without making that function a template
+ *
+ * Each object holds a pointer to a function which invokes its callable, so a call is a single indirect call, as with a virtual function. An empty
+ * object holds a pointer to a function which throws 'std::bad_function_call', so calls don't check for emptiness. Callables which are trivially
+ * copyable and destructible (e.g. closures which only capture references and scalars) are copied with 'memcpy', and need no destructor call.
+ */
+namespace callbacks {
+
+  // Fits closures which capture up to three pointers (or references)
+  inline constexpr std::size_t defaultCapacity = 3 * sizeof(void*);
+
+  namespace detail {
+
+    template<typename F>
+    constexpr bool isTrivial = std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
+
+    // Copies, moves, and destroys the callable in a buffer; unused for trivial callables
+    struct Manager {
+      void (*copy)(void* destination, const void* source);
+      // Move-constructs 'destination' from 'source', then destroys 'source'
+      void (*relocate)(void* destination, void* source);
+      void (*destroy)(void* callable);
+    };
+
+    template<typename F, bool Copyable>
+    struct ManagerFor {
+
+      static void copy(void* destination, const void* source) {
+        if constexpr (Copyable) {
+          ::new (destination) F(*static_cast<const F*>(source));
+        }
+      }
+
+      static void relocate(void* destination, void* source) {
+        ::new (destination) F(std::move(*static_cast<F*>(source)));
+        static_cast<F*>(source)->~F();
+      }
+
+      static void destroy(void* callable) {
+        static_cast<F*>(callable)->~F();
+      }
+
+      static constexpr Manager manager{Copyable ? &copy : nullptr, &relocate, &destroy};
+    };
+
+    // 'std::invoke', converting the result to 'R' (or discarding it, if 'R' is 'void')
+    template<typename R, typename F, typename ... Args>
+    R invokeR(F&& f, Args&& ... args) {
+      if constexpr (std::is_void_v<R>) {
+        std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+      } else {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+      }
+    }
+
+    template<typename R, typename ... Args>
+    [[noreturn]] R throwEmpty(void*, Args&& ...) {
+      throw std::bad_function_call();
+    }
+
+    template<typename F, typename R, typename ... Args>
+    R invokeStored(void* callable, Args&& ... args) {
+      return invokeR<R>(*static_cast<F*>(callable), std::forward<Args>(args)...);
+    }
+
+    template<bool Copyable, std::size_t Capacity, typename R, typename ... Args>
+    class InplaceStorage {
+
+      using Invoker = R (*)(void*, Args&& ...);
+
+      alignas(std::max_align_t) mutable unsigned char buffer[Capacity];
+      Invoker invoker = &throwEmpty<R, Args...>;
+      // Null for trivial callables (and when empty)
+      const Manager* manager = nullptr;
+
+      void reset() {
+        if (manager) {
+          manager->destroy(buffer);
+        }
+        invoker = &throwEmpty<R, Args...>;
+        manager = nullptr;
+      }
+
+      // Requires this to be empty
+      void copyFrom(const InplaceStorage& other) {
+        if (other.manager) {
+          other.manager->copy(buffer, other.buffer);
+        } else {
+          std::memcpy(buffer, other.buffer, Capacity);
+        }
+        invoker = other.invoker;
+        manager = other.manager;
+      }
+
+      // Requires this to be empty; leaves 'other' empty
+      void moveFrom(InplaceStorage& other) {
+        if (other.manager) {
+          other.manager->relocate(buffer, other.buffer);
+        } else {
+          std::memcpy(buffer, other.buffer, Capacity);
+        }
+        invoker = other.invoker;
+        manager = other.manager;
+        other.invoker = &throwEmpty<R, Args...>;
+        other.manager = nullptr;
+      }
+
+    public:
+
+      InplaceStorage() = default;
+
+      template<typename F>
+      requires (!std::is_same_v<std::remove_cvref_t<F>, InplaceStorage> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+      InplaceStorage(F&& f) {
+        using Callable = std::decay_t<F>;
+
+        static_assert(sizeof(Callable) <= Capacity, "The callable doesn't fit into the buffer: increase the capacity");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "The callable is over-aligned");
+        static_assert(!Copyable || std::is_copy_constructible_v<Callable>, "The callable isn't copyable: use InplaceMoveOnlyFunction");
+        static_assert(std::is_nothrow_move_constructible_v<Callable>, "The callable must be nothrow move constructible");
+
+        ::new (static_cast<void*>(buffer)) Callable(std::forward<F>(f));
+        invoker = &invokeStored<Callable, R, Args...>;
+        if constexpr (!isTrivial<Callable>) {
+          manager = &ManagerFor<Callable, Copyable>::manager;
+        }
+      }
+
+      InplaceStorage(const InplaceStorage& other) requires Copyable {
+        copyFrom(other);
+      }
+
+      InplaceStorage(InplaceStorage&& other) noexcept {
+        moveFrom(other);
+      }
+
+      InplaceStorage& operator=(const InplaceStorage& other) requires Copyable {
+        if (this != &other) {
+          reset();
+          copyFrom(other);
+        }
+        return *this;
+      }
+
+      InplaceStorage& operator=(InplaceStorage&& other) noexcept {
+        if (this != &other) {
+          reset();
+          moveFrom(other);
+        }
+        return *this;
+      }
+
+      InplaceStorage& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+      }
+
+      ~InplaceStorage() {
+        if (manager) {
+          manager->destroy(buffer);
+        }
+      }
+
+      // Like 'std::function', calling is 'const' even if the callable isn't
+      R operator()(Args ... args) const {
+        return invoker(buffer, std::forward<Args>(args)...);
+      }
+
+      explicit operator bool() const {
+        return invoker != &throwEmpty<R, Args...>;
+      }
+
+    };
+
+  }
+
+  template<typename Signature, std::size_t Capacity = defaultCapacity>
+  class InplaceFunction;
+
+  template<typename R, typename ... Args, std::size_t Capacity>
+  class InplaceFunction<R(Args...), Capacity> : public detail::InplaceStorage<true, Capacity, R, Args...> {
+
+    using Storage = detail::InplaceStorage<true, Capacity, R, Args...>;
+
+  public:
+
+    using Storage::Storage;
+
+    // Replaces the callable (leaving this unchanged if copying it throws). The assignments of the base aren't inherited: a callable converts to
+    // both this class and the base, so assigning one would be ambiguous between their move assignments.
+    template<typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InplaceFunction& operator=(F&& f) {
+      Storage::operator=(Storage(std::forward<F>(f)));
+      return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) {
+      Storage::operator=(nullptr);
+      return *this;
+    }
+
+  };
+
+  template<typename Signature, std::size_t Capacity = defaultCapacity>
+  class InplaceMoveOnlyFunction;
+
+  template<typename R, typename ... Args, std::size_t Capacity>
+  class InplaceMoveOnlyFunction<R(Args...), Capacity> : public detail::InplaceStorage<false, Capacity, R, Args...> {
+
+    using Storage = detail::InplaceStorage<false, Capacity, R, Args...>;
+
+  public:
+
+    using Storage::Storage;
+
+    // As in 'InplaceFunction'
+    template<typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, InplaceMoveOnlyFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    InplaceMoveOnlyFunction& operator=(F&& f) {
+      Storage::operator=(Storage(std::forward<F>(f)));
+      return *this;
+    }
+
+    InplaceMoveOnlyFunction& operator=(std::nullptr_t) {
+      Storage::operator=(nullptr);
+      return *this;
+    }
+
+  };
+
+  // A non-owning reference to a callable, which must outlive the reference (so don't bind it to a temporary which is called later)
+  template<typename Signature>
+  class FunctionRef;
+
+  template<typename R, typename ... Args>
+  class FunctionRef<R(Args...)> {
+
+    // Function pointers can't be converted to 'void*', so they are stored separately
+    union Target {
+      void* object;
+      void (*function)();
+    };
+
+    Target target;
+    R (*invoker)(Target, Args&& ...);
+
+  public:
+
+    template<typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, FunctionRef> && std::is_invocable_r_v<R, F&, Args...>)
+    FunctionRef(F&& f) noexcept {
+      if constexpr (std::is_function_v<std::remove_pointer_t<std::remove_cvref_t<F>>>) {
+        target.function = reinterpret_cast<void (*)()>(+f);
+        invoker = [](Target t, Args&& ... args) -> R {
+          return detail::invokeR<R>(reinterpret_cast<std::remove_pointer_t<std::remove_cvref_t<F>>*>(t.function), std::forward<Args>(args)...);
+        };
+      } else {
+        target.object = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        invoker = [](Target t, Args&& ... args) -> R {
+          return detail::invokeR<R>(*static_cast<std::remove_reference_t<F>*>(t.object), std::forward<Args>(args)...);
+        };
+      }
+    }
+
+    R operator()(Args ... args) const {
+      return invoker(target, std::forward<Args>(args)...);
+    }
+
+  };
+
+}
+
+#endif // FUNCTIONS_INPLACEFUNCTION_H
@@ -1,6 +1,6 @@
 #ifndef FUNCTIONS_LAMBDA_H
 #define FUNCTIONS_LAMBDA_H
 
-void lambdaExample(int i);
+void lambdaExample();
 
 #endif // FUNCTIONS_LAMBDA_H
@@ -1,10 +1,12 @@
 #include <iostream>
 
+#include "inplaceFunction.h"
 #include "lambda.h"
+#include "registry.h"
 
-template<typename Func>
+// Takes any callable through a non-owning reference, rather than as a template parameter, so that it's compiled once rather than once per lambda
 //void lambdaHelper(int (*f)(int i)) {
-void lambdaHelper(Func f) {
+void lambdaHelper(callbacks::FunctionRef<int(int)> f) {
   
   const int input = 42;
   
@@ -28,4 +30,14 @@ void lambdaExample() {
   // Closure which captures and renames local objects
   lambdaHelper([&a = x, x = x - 1](int i) { return a - x; });
   
+  // Closure stored for later: its captures are kept in the inline buffer of the InplaceFunction, instead of on the heap
+  callbacks::InplaceFunction<int(int), 16> stored = [&a = x, x = x - 1](int i) { return a - x; };
+  lambdaHelper(stored);
+  
+  // Another closure assigned to it, destroying the previous one
+  stored = [x](int i) { return i * x; };
+  lambdaHelper(stored);
+  
 }
+
+REGISTER_EXAMPLE("functions/lambdaExample", lambdaExample);
@@ -0,0 +1,101 @@
+#ifndef PREPROCESSOR_PLATFORM_H
+#define PREPROCESSOR_PLATFORM_H
+
+#include <cstddef>
+#include <iosfwd>
+
+/**
+ * The machine the program is running on, as opposed to the machine it was compiled for. Predefined macros (see 'predefinedMacros' in
+ * "replacement.h") describe the compilation target: '__AVX2__' is only defined if the compiler was allowed to emit AVX2 everywhere, and
+ * '__STDCPP_DEFAULT_NEW_ALIGNMENT__' says nothing about caches. A binary built once runs on many machines, so code which tunes itself to the
+ * hardware (choosing a SIMD implementation, sizing blocks to fit a cache, sizing a thread pool) must ask at runtime:
+ *
+ * - Instruction set extensions, from the 'cpuid' instruction (x86 only), including whether the OS saves the registers they use ('xgetbv')
+ * - Cache levels, sizes, and line sizes, from '/sys/devices/system/cpu/cpu0/cache', or 'sysconf' if that isn't available
+ * - Logical CPUs, physical cores, packages, and NUMA nodes, from '/sys/devices/system/cpu' and '/sys/devices/system/node', and the CPUs which this
+ *   process may run on (its affinity mask, which is smaller than the machine in a container or under 'taskset')
+ * - Huge page sizes and availability, from '/proc/meminfo' and '/sys/kernel/mm/transparent_hugepage'
+ *
+ * Detection reads a few dozen small files, so it runs once, on the first call to 'info()', and the result is cached for the lifetime of the process:
+ * after that, every query is a load. Values which can't be detected fall back to conservative defaults (e.g. a 64-byte line, one NUMA node).
+ */
+namespace platform {
+
+  struct Features {
+    bool sse2 = false;
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512dq = false;
+    bool avx512vl = false;
+  };
+
+  enum class CacheType { data, instruction, unified };
+
+  struct Cache {
+    int level;
+    CacheType type;
+    std::size_t size;
+    std::size_t lineSize;
+    // 0 if unknown
+    unsigned associativity;
+    // The number of logical CPUs which share this cache (e.g. 2 for a core's L1 with SMT, every core of a package for its L3)
+    unsigned sharedBy;
+  };
+
+  struct Topology {
+    unsigned logicalCpus = 1;
+    unsigned physicalCores = 1;
+    unsigned packages = 1;
+    unsigned numaNodes = 1;
+    // The number of logical CPUs this process is allowed to run on
+    unsigned availableCpus = 1;
+  };
+
+  struct HugePages {
+    // The size of a huge page, or 0 if huge pages aren't supported
+    std::size_t size = 0;
+    // The number of huge pages reserved for explicit use (e.g. 'mmap' with 'MAP_HUGETLB'), and how many of them are free
+    std::size_t reserved = 0;
+    std::size_t free = 0;
+    // Whether transparent huge pages are used for all memory, or only for memory marked with 'madvise(MADV_HUGEPAGE)'
+    bool transparentAlways = false;
+    bool transparentMadvise = false;
+  };
+
+  struct Info {
+    Features features;
+    // Ordered by level, then data, instruction, and unified; 'cacheCount' entries are valid
+    Cache caches[8];
+    std::size_t cacheCount = 0;
+    // The line size of the first-level data cache
+    std::size_t lineSize = 64;
+    Topology topology;
+    HugePages hugePages;
+  };
+
+  // Detected on the first call; thread-safe
+  const Info& info();
+
+  const Features& features();
+
+  // The line size of the first-level data cache
+  std::size_t cacheLineSize();
+
+  // The size of the data (or unified) cache of the given level, e.g. 2 for the L2 cache, or 0 if there is no such cache
+  std::size_t dataCacheSize(int level);
+
+  // The number of threads to use for CPU-bound work: the number of CPUs this process may run on
+  unsigned availableCpus();
+
+  // Writes a human-readable summary of 'info()', one fact per line
+  void report(std::ostream& out);
+
+}
+
+#endif // PREPROCESSOR_PLATFORM_H
@@ -0,0 +1,105 @@
+#ifndef PREPROCESSOR_REGISTRY_H
+#define PREPROCESSOR_REGISTRY_H
+
+#include <algorithm>
+#include <span>
+#include <string_view>
+
+/**
+ * Self-registration without static initialization. The usual way for code to register itself (e.g. a benchmark or an example) is a global object
+ * whose constructor appends to a global container: that costs a dynamic initializer and a heap allocation per entry at startup, and the order in
+ * which the initializers of different translation units run is unspecified, so the container must be a function-local static.
+ *
+ * 'REGISTRY_ADD' instead uses the replacement-macro technique (see "replacement.cpp") to stamp out a 'constinit' variable, with a unique name
+ * pasted together from '__COUNTER__', and asks the compiler to place it in a named section of the object file. The linker concatenates the
+ * sections of the same name from every object file into one contiguous array, and (since the name is a valid identifier) defines the symbols
+ * '__start_<section>' and '__stop_<section>' at its bounds. Registration therefore happens entirely at build time: the entries are initialized
+ * data, and 'REGISTRY_DEFINE_TABLE' defines a function which returns them as a 'std::span'.
+ *
+ *   REGISTRY_ADD(examples, registry::Example, "preprocessor/controlSuccess", controlSuccess)   // at namespace scope, in any source file
+ *   REGISTRY_DEFINE_TABLE(examples, examples, registry::Example)                              // in one source file
+ *
+ *   for (const auto& r : examples()) { r.entry.run(); }
+ *
+ * The order of the entries in the section is the link order of the object files, and is unspecified within an object file, so the table is sorted
+ * by source file and registration order when it's first requested (in place, without allocating).
+ *
+ * The section bounds are defined per linked module: a table defined in a shared library only sees the entries registered in that library, and a
+ * table defined in an executable only sees the entries registered in the executable. This relies on the GNU toolchain (GCC or Clang, with an ELF
+ * linker).
+ */
+namespace registry {
+
+  template<typename T>
+  struct Registration {
+    T entry;
+    const char* file;
+    // The position of the registration within its source file
+    int order;
+  };
+
+  template<typename T>
+  using Table = std::span<const Registration<T>>;
+
+  struct Example {
+    const char* name;
+    void (*run)();
+  };
+
+  // Whether 'name' matches the glob 'pattern' as a whole: '*' matches any sequence of characters (including '/'), and '?' matches any character
+  bool globMatch(std::string_view pattern, std::string_view name);
+
+  // Whether 'name' is selected by 'filter': a glob if it contains '*' or '?', otherwise a substring of the name; an empty filter selects everything
+  bool matches(std::string_view filter, std::string_view name);
+
+  // Every example registered in the calling module, from every library: the libraries' sources are compiled into each module which links them, so
+  // this is a single table of all the examples which the module can run
+  Table<Example> examples();
+
+}
+
+#define REGISTRY_CONCAT_(a, b) a##b
+#define REGISTRY_CONCAT(a, b) REGISTRY_CONCAT_(a, b)
+
+// The alignment is explicit, since compilers may otherwise over-align large variables, which would leave gaps between the entries of the section
+#define REGISTRY_ADD_(table, Type, id, ...)                                                                                                      \
+  [[gnu::used, gnu::section("registry_" #table), gnu::aligned(alignof(::registry::Registration<Type>))]]                                         \
+  constinit static ::registry::Registration<Type> REGISTRY_CONCAT(registryEntry_, id){{__VA_ARGS__}, __FILE__, id}
+
+// Registers an entry of type 'Type', initialized from the remaining arguments, in the table 'table'; must be used at namespace scope
+#define REGISTRY_ADD(table, Type, ...) REGISTRY_ADD_(table, Type, __COUNTER__, __VA_ARGS__)
+
+// Defines 'function', which returns the entries of 'table' registered in this module; the bounds are weak, so a table may be empty
+#define REGISTRY_DEFINE_TABLE(function, table, Type)                                                                                             \
+  extern "C" [[gnu::weak, gnu::visibility("hidden")]] ::registry::Registration<Type> __start_registry_##table[];                                \
+  extern "C" [[gnu::weak, gnu::visibility("hidden")]] ::registry::Registration<Type> __stop_registry_##table[];                                 \
+                                                                                                                                                 \
+  ::registry::Table<Type> function() {                                                                                                           \
+    static const ::registry::Table<Type> sorted = ::registry::detail::sort(__start_registry_##table, __stop_registry_##table);                   \
+    return sorted;                                                                                                                               \
+  }
+
+// Registers a function which takes no arguments as an example, e.g. 'REGISTER_EXAMPLE("preprocessor/controlSuccess", controlSuccess)'; the name
+// starts with the library, so that a filter such as "expressions/*" selects the examples of one library
+#define REGISTER_EXAMPLE(name, function) REGISTRY_ADD(examples, ::registry::Example, name, function)
+
+namespace registry::detail {
+
+  template<typename T>
+  Table<T> sort(Registration<T>* first, Registration<T>* last) {
+
+    if (!first) {
+      return {};
+    }
+
+    std::sort(first, last, [](const Registration<T>& a, const Registration<T>& b) {
+      int files = std::string_view(a.file).compare(b.file);
+      return (files < 0) || (files == 0 && a.order < b.order);
+    });
+
+    return {first, last};
+  }
+
+}
+
+#endif // PREPROCESSOR_REGISTRY_H
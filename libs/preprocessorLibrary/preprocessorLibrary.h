@@ -3,6 +3,8 @@
 
 #include "control.h"
 #include "inclusion.h"
+#include "platform.h"
+#include "registry.h"
 #include "replacement.h"
 
 #endif // PREPROCESSORLIBRARY_H
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "control.h"
+#include "registry.h"
 
 void controlSuccess() {
 
@@ -14,3 +15,5 @@ void controlSuccess() {
 }
 
 #undef DEFINED
+
+REGISTER_EXAMPLE("preprocessor/controlSuccess", controlSuccess);
@@ -3,6 +3,7 @@
 #if __has_include("inclusion.h")  // conditional evaluation of a constant expression; __has_include returns 1 if the filename can be found, else 0
 #include "inclusion.h"
 #endif                            // Required directive to signal end of if directive
+#include "registry.h"
 
 #define DEFINED
 
@@ -27,3 +28,5 @@ void inclusionSuccess() {
 }
 
 #undef DEFINED
+
+REGISTER_EXAMPLE("preprocessor/inclusionSuccess", inclusionSuccess);
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "platform.h"
+
+namespace platform {
+
+  namespace {
+
+    constexpr std::string_view cpuRoot = "/sys/devices/system/cpu/";
+
+    // The first line of a (pseudo) file, or an empty string if it can't be read
+    std::string readLine(const std::string& path) {
+      std::ifstream file(path);
+      std::string line;
+      std::getline(file, line);
+      return line;
+    }
+
+    std::size_t parseNumber(std::string_view s, std::size_t& position) {
+      std::size_t n = 0;
+      while (position < s.size() && s[position] >= '0' && s[position] <= '9') {
+        n = n * 10 + (s[position++] - '0');
+      }
+      return n;
+    }
+
+    // Sizes in /sys are written as e.g. "48K" or "2048K"
+    std::size_t parseSize(std::string_view s) {
+      std::size_t position = 0;
+      std::size_t n = parseNumber(s, position);
+      if (position < s.size()) {
+        switch (s[position]) {
+          case 'K': return n << 10;
+          case 'M': return n << 20;
+          case 'G': return n << 30;
+        }
+      }
+      return n;
+    }
+
+    // CPU and node lists in /sys are written as ranges, e.g. "0-3,8-11"; calls 'f' with every element
+    template<typename F>
+    void forEachInList(std::string_view s, F&& f) {
+      std::size_t position = 0;
+      while (position < s.size() && s[position] >= '0' && s[position] <= '9') {
+        std::size_t first = parseNumber(s, position);
+        std::size_t last = first;
+        if (position < s.size() && s[position] == '-') {
+          ++position;
+          last = parseNumber(s, position);
+        }
+        for (std::size_t i = first; i <= last; ++i) {
+          f(i);
+        }
+        if (position < s.size() && s[position] == ',') {
+          ++position;
+        }
+      }
+    }
+
+    unsigned countList(std::string_view s) {
+      unsigned count = 0;
+      forEachInList(s, [&](std::size_t) { ++count; });
+      return count;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // The register state components which the OS saves on context switches; AVX needs XMM and YMM state, AVX-512 also needs the mask and ZMM state
+    unsigned long long xgetbv() {
+      unsigned low;
+      unsigned high;
+      asm volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+      return (static_cast<unsigned long long>(high) << 32) | low;
+    }
+
+    Features detectFeatures() {
+
+      Features f;
+      unsigned a, b, c, d;
+
+      if (!__get_cpuid(1, &a, &b, &c, &d)) {
+        return f;
+      }
+
+      const unsigned long long xcr0 = (c & bit_OSXSAVE) ? xgetbv() : 0;
+      const bool ymm = (xcr0 & 0x06) == 0x06;
+      const bool zmm = (xcr0 & 0xE6) == 0xE6;
+
+      f.sse2 = d & bit_SSE2;
+      f.sse42 = c & bit_SSE4_2;
+      f.popcnt = c & bit_POPCNT;
+      f.avx = (c & bit_AVX) && ymm;
+      f.fma = (c & bit_FMA) && ymm;
+
+      if (__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+        f.avx2 = (b & bit_AVX2) && ymm;
+        f.bmi2 = b & bit_BMI2;
+        f.avx512f = (b & bit_AVX512F) && zmm;
+        f.avx512bw = (b & bit_AVX512BW) && zmm;
+        f.avx512dq = (b & bit_AVX512DQ) && zmm;
+        f.avx512vl = (b & bit_AVX512VL) && zmm;
+      }
+
+      return f;
+    }
+#else
+    Features detectFeatures() {
+      return {};
+    }
+#endif
+
+    void detectCaches(Info& info) {
+
+      for (int index = 0; info.cacheCount < std::size(info.caches); ++index) {
+        const std::string dir = std::string(cpuRoot) + "cpu0/cache/index" + std::to_string(index) + "/";
+        const std::string level = readLine(dir + "level");
+        if (level.empty()) {
+          break;
+        }
+
+        const std::string type = readLine(dir + "type");
+        Cache& cache = info.caches[info.cacheCount++];
+        cache.level = std::stoi(level);
+        cache.type = (type == "Data") ? CacheType::data : (type == "Instruction") ? CacheType::instruction : CacheType::unified;
+        cache.size = parseSize(readLine(dir + "size"));
+        cache.lineSize = parseSize(readLine(dir + "coherency_line_size"));
+        cache.associativity = static_cast<unsigned>(parseSize(readLine(dir + "ways_of_associativity")));
+        cache.sharedBy = std::max(1u, countList(readLine(dir + "shared_cpu_list")));
+      }
+
+      // Without /sys (e.g. in some sandboxes), glibc reports the sizes which it found with 'cpuid'
+      if (info.cacheCount == 0) {
+        const std::pair<int, int> levels[] = {{_SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL1_DCACHE_LINESIZE}, {_SC_LEVEL2_CACHE_SIZE, _SC_LEVEL2_CACHE_LINESIZE},
+                                              {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL3_CACHE_LINESIZE}};
+        for (int level = 1; level <= 3; ++level) {
+          long size = sysconf(levels[level - 1].first);
+          long lineSize = sysconf(levels[level - 1].second);
+          if (size > 0) {
+            CacheType type = (level == 1) ? CacheType::data : CacheType::unified;
+            info.caches[info.cacheCount++] = {level, type, static_cast<std::size_t>(size), static_cast<std::size_t>(std::max(lineSize, 0L)), 0, 1};
+          }
+        }
+      }
+
+      std::sort(info.caches, info.caches + info.cacheCount, [](const Cache& a, const Cache& b) {
+        return std::pair(a.level, a.type) < std::pair(b.level, b.type);
+      });
+
+      for (std::size_t i = 0; i < info.cacheCount; ++i) {
+        if (info.caches[i].type != CacheType::instruction && info.caches[i].lineSize) {
+          info.lineSize = info.caches[i].lineSize;
+          break;
+        }
+      }
+    }
+
+    void detectTopology(Topology& topology) {
+
+      std::set<std::pair<std::size_t, std::size_t>> cores;
+      std::set<std::size_t> packages;
+      unsigned logical = 0;
+
+      forEachInList(readLine(std::string(cpuRoot) + "online"), [&](std::size_t cpu) {
+        const std::string dir = std::string(cpuRoot) + "cpu" + std::to_string(cpu) + "/topology/";
+        std::size_t package = parseSize(readLine(dir + "physical_package_id"));
+        packages.insert(package);
+        cores.insert({package, parseSize(readLine(dir + "core_id"))});
+        ++logical;
+      });
+
+      if (logical == 0) {
+        logical = std::max(1u, std::thread::hardware_concurrency());
+        cores.insert({0, 0});
+        packages.insert(0);
+      }
+
+      topology.logicalCpus = logical;
+      topology.physicalCores = std::max<unsigned>(1, static_cast<unsigned>(cores.size()));
+      topology.packages = std::max<unsigned>(1, static_cast<unsigned>(packages.size()));
+      topology.numaNodes = std::max(1u, countList(readLine("/sys/devices/system/node/online")));
+
+      cpu_set_t affinity;
+      topology.availableCpus = (sched_getaffinity(0, sizeof(affinity), &affinity) == 0) ? std::max(1, CPU_COUNT(&affinity)) : logical;
+    }
+
+    void detectHugePages(HugePages& hugePages) {
+
+      std::ifstream meminfo("/proc/meminfo");
+      std::string key;
+      std::size_t value;
+      while (meminfo >> key >> value) {
+        if (key == "Hugepagesize:") {
+          hugePages.size = value * 1024;
+        } else if (key == "HugePages_Total:") {
+          hugePages.reserved = value;
+        } else if (key == "HugePages_Free:") {
+          hugePages.free = value;
+        }
+        meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      }
+
+      // The current mode is in brackets, e.g. "always [madvise] never"
+      const std::string mode = readLine("/sys/kernel/mm/transparent_hugepage/enabled");
+      hugePages.transparentAlways = mode.find("[always]") != std::string::npos;
+      hugePages.transparentMadvise = mode.find("[madvise]") != std::string::npos;
+    }
+
+    Info detect() {
+      Info info;
+      info.features = detectFeatures();
+      detectCaches(info);
+      detectTopology(info.topology);
+      detectHugePages(info.hugePages);
+      return info;
+    }
+
+    const char* cacheTypeName(CacheType type) {
+      switch (type) {
+        case CacheType::data: return "data";
+        case CacheType::instruction: return "instruction";
+        default: return "unified";
+      }
+    }
+
+  }
+
+  const Info& info() {
+    static const Info detected = detect();
+    return detected;
+  }
+
+  const Features& features() {
+    return info().features;
+  }
+
+  std::size_t cacheLineSize() {
+    return info().lineSize;
+  }
+
+  std::size_t dataCacheSize(int level) {
+    const Info& i = info();
+    for (std::size_t c = 0; c < i.cacheCount; ++c) {
+      if (i.caches[c].level == level && i.caches[c].type != CacheType::instruction) {
+        return i.caches[c].size;
+      }
+    }
+    return 0;
+  }
+
+  unsigned availableCpus() {
+    return info().topology.availableCpus;
+  }
+
+  void report(std::ostream& out) {
+
+    const Info& i = info();
+    const Features& f = i.features;
+
+    out << "Instruction set extensions:";
+    const std::pair<bool, const char*> extensions[] = {{f.sse2, "sse2"}, {f.sse42, "sse4.2"}, {f.popcnt, "popcnt"}, {f.avx, "avx"}, {f.avx2, "avx2"},
+                                                       {f.fma, "fma"}, {f.bmi2, "bmi2"}, {f.avx512f, "avx512f"}, {f.avx512bw, "avx512bw"},
+                                                       {f.avx512dq, "avx512dq"}, {f.avx512vl, "avx512vl"}};
+    for (const auto& [supported, name] : extensions) {
+      if (supported) {
+        out << ' ' << name;
+      }
+    }
+    out << '\n';
+
+    for (std::size_t c = 0; c < i.cacheCount; ++c) {
+      const Cache& cache = i.caches[c];
+      out << "L" << cache.level << ' ' << cacheTypeName(cache.type) << " cache: " << cache.size / 1024 << " KiB, " << cache.lineSize
+          << "-byte lines, shared by " << cache.sharedBy << " CPUs\n";
+    }
+
+    const Topology& t = i.topology;
+    out << "CPUs: " << t.logicalCpus << " logical (" << t.availableCpus << " available), " << t.physicalCores << " cores, " << t.packages
+        << " packages, " << t.numaNodes << " NUMA nodes\n";
+
+    const HugePages& h = i.hugePages;
+    out << "Huge pages: " << h.size / 1024 << " KiB, " << h.free << " of " << h.reserved << " reserved pages free, transparent "
+        << (h.transparentAlways ? "always" : h.transparentMadvise ? "with madvise" : "never") << '\n';
+  }
+
+}
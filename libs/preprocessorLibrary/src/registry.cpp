@@ -0,0 +1,45 @@
+#include "registry.h"
+
+namespace registry {
+
+  REGISTRY_DEFINE_TABLE(examples, examples, Example)
+
+  bool globMatch(std::string_view pattern, std::string_view name) {
+
+    // Greedy matching with backtracking to the most recent '*': only the last '*' ever needs to be retried, since any match of an earlier '*' can be
+    // extended by the later one, so this takes O(pattern * name) time in the worst case, and no extra memory
+    std::size_t p = 0;
+    std::size_t n = 0;
+    std::size_t star = std::string_view::npos;
+    std::size_t starMatch = 0;
+
+    while (n < name.size()) {
+      if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+        ++p;
+        ++n;
+      } else if (p < pattern.size() && pattern[p] == '*') {
+        star = p++;
+        starMatch = n;
+      } else if (star != std::string_view::npos) {
+        p = star + 1;
+        n = ++starMatch;
+      } else {
+        return false;
+      }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+      ++p;
+    }
+    return p == pattern.size();
+  }
+
+  bool matches(std::string_view filter, std::string_view name) {
+
+    if (filter.find_first_of("*?") != std::string_view::npos) {
+      return globMatch(filter, name);
+    }
+    return name.find(filter) != std::string_view::npos;
+  }
+
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 
+#include "platform.h"
 #include "replacement.h"
+#include "registry.h"
 
 // Define an identifier (empty object macro)
 #define IDENTIFIER
@@ -55,4 +57,10 @@ void predefinedMacros() {
   
   // Compilers may also have their own additional predefined macros available
   
+  // All of the above describe the machine which the program was compiled for; the machine it runs on can only be queried at runtime
+  platform::report(std::cout);
+  
 }
+
+REGISTER_EXAMPLE("preprocessor/replacementSuccess", replacementSuccess);
+REGISTER_EXAMPLE("preprocessor/predefinedMacros", predefinedMacros);
@@ -3,4 +3,7 @@
 
 int attributeExample(int x);
 
+// Calls 'attributeExample' with a range of arguments
+void attributeHints();
+
 #endif // SPECIFIERS_ATTRIBUTES_H
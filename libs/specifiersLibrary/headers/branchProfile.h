@@ -0,0 +1,121 @@
+#ifndef SPECIFIERS_BRANCHPROFILE_H
+#define SPECIFIERS_BRANCHPROFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+#include "cacheAligned.h"
+
+/**
+ * Checks '[[likely]]' and '[[unlikely]]' against reality. The attributes are hints which the compiler trusts blindly: it moves an unlikely branch
+ * out of the hot path, so a wrong hint makes the common case slower than no hint at all. These macros keep the hints, and (if BRANCH_PROFILING is
+ * defined) also count how often each hinted branch is taken, relative to how often the decision between the branches is made:
+ *
+ *   BRANCH_DECISION(parse);
+ *   switch (c) {
+ *     case '\n': BRANCH_UNLIKELY(parse);
+ *       ...
+ *     default: BRANCH_LIKELY(parse);
+ *       ...
+ *   }
+ *
+ * 'branches::report' then lists every hinted branch with the fraction of decisions which took it, and flags the hints which the counts contradict: a
+ * likely branch taken by less than half of the decisions, or an unlikely branch taken by more than half. Configuring with '-DBRANCH_PROFILING=ON'
+ * defines BRANCH_PROFILING for the whole build, and writes the report to standard error when the program exits.
+ *
+ * Without BRANCH_PROFILING, 'BRANCH_DECISION' expands to nothing and 'BRANCH_LIKELY'/'BRANCH_UNLIKELY' expand to the bare attributes, so the
+ * instrumentation can stay in production code. With it, each site is a function-local static, and each hit is a relaxed increment of a counter of
+ * the calling thread (see 'PerThread' in "cacheAligned.h"), so threads don't contend for the counters.
+ *
+ * 'BRANCH_DECISION' declares a local variable named after the decision, which the hinted branches refer to: each branch is therefore counted against
+ * the decision in its own enclosing scope, even in overloads, templates, and lambdas (which share a '__func__'), and a branch without a decision
+ * doesn't compile. Sites are reported by file and line.
+ */
+namespace branches {
+
+  enum class Hint { none, likely, unlikely };
+
+  // A counted point in the code: either a decision, or a hinted branch of a decision
+  class Site {
+
+    alignment::PerThread<std::atomic<std::uint64_t>> counts;
+
+  public:
+
+    const std::string_view decision;
+    const std::string_view function;
+    const std::string_view file;
+    const int line;
+    const Hint hint;
+    // The decision which a hinted branch belongs to; null for a decision
+    const Site* const decisionSite;
+
+    // Registers the site for reporting; sites must outlive any call to 'collect' or 'report'
+    Site(std::string_view decision, std::string_view function, std::string_view file, int line, Hint hint, const Site* decisionSite);
+
+    ~Site();
+
+    Site(const Site&) = delete;
+    Site& operator=(const Site&) = delete;
+
+    void hit() {
+      counts.local().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The sum of the counts of all threads
+    std::uint64_t hits() const;
+
+    void reset();
+
+  };
+
+  struct BranchReport {
+    const Site* branch;
+    // The number of times the decision containing the branch was made
+    std::uint64_t decisions;
+    std::uint64_t hits;
+    // 'hits / decisions', or 0 if there were no decisions
+    double ratio;
+    bool contradictsHint;
+  };
+
+  // A likely branch taken by less than this fraction of decisions, or an unlikely branch taken by more, contradicts its hint
+  inline constexpr double contradictionThreshold = 0.5;
+
+  // The counts of every hinted branch which has been reached at least once, sorted by file and line
+  std::vector<BranchReport> collect();
+
+  // Writes the counts of every hinted branch to 'out', one per line, marking the branches which contradict their hints
+  void report(std::ostream& out);
+
+  // Zeroes all counts
+  void reset();
+
+}
+
+// Sites are allocated and never destroyed, so that they are all still alive when the report is written at exit
+#define BRANCH_PROFILE_NEW_SITE_(decision, hint, decisionSite)                                                           \
+  (*new ::branches::Site(#decision, __func__, __FILE__, __LINE__, hint, decisionSite))
+
+#define BRANCH_PROFILE_BRANCH_(decision, hint)                                                                            \
+  do {                                                                                                                    \
+    static ::branches::Site& branchProfileSite_ = BRANCH_PROFILE_NEW_SITE_(decision, hint, &branchDecision_##decision);   \
+    branchProfileSite_.hit();                                                                                             \
+  } while (false)
+
+#if defined(BRANCH_PROFILING)
+#define BRANCH_DECISION(decision)                                                                                         \
+  static ::branches::Site& branchDecision_##decision = BRANCH_PROFILE_NEW_SITE_(decision, ::branches::Hint::none, nullptr); \
+  branchDecision_##decision.hit()
+#define BRANCH_LIKELY(decision) [[likely]] BRANCH_PROFILE_BRANCH_(decision, ::branches::Hint::likely)
+#define BRANCH_UNLIKELY(decision) [[unlikely]] BRANCH_PROFILE_BRANCH_(decision, ::branches::Hint::unlikely)
+#else
+#define BRANCH_DECISION(decision) static_cast<void>(0)
+#define BRANCH_LIKELY(decision) [[likely]] static_cast<void>(0)
+#define BRANCH_UNLIKELY(decision) [[unlikely]] static_cast<void>(0)
+#endif
+
+#endif // SPECIFIERS_BRANCHPROFILE_H
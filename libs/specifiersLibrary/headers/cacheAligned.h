@@ -0,0 +1,146 @@
+#ifndef SPECIFIERS_CACHEALIGNED_H
+#define SPECIFIERS_CACHEALIGNED_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Building blocks against false sharing. Caches move memory in lines (usually 64 bytes): when one core writes to a line, every other core must drop
+ * its copy of the whole line. Two threads which write to different objects in the same line therefore take turns owning the line, as if they were
+ * writing to the same object, although they never share any data. Placing each such object on its own line avoids this.
+ *
+ * 'alignas' (see "specifiers.h") is the tool, but the right value is easy to get wrong: 'CacheAligned<T>' aligns and pads 'T' to a whole number of
+ * lines, and 'PerThread<T>' is an array of such slots, one per thread.
+ */
+namespace alignment {
+
+  // The minimum distance between two objects written by different threads to avoid false sharing. The value changes the layout of the types below,
+  // so all code which shares them must agree on it: it can be fixed by defining CACHE_LINE_SIZE. Otherwise, it is the destructive interference size of
+  // the target, if the standard library provides it, and otherwise 128 bytes on targets whose caches use 128-byte lines (or fetch lines in pairs),
+  // and 64 bytes on all others.
+#if defined(CACHE_LINE_SIZE)
+  inline constexpr std::size_t cacheLineSize = CACHE_LINE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+  inline constexpr std::size_t cacheLineSize = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#elif defined(__aarch64__) || defined(__powerpc64__)
+  inline constexpr std::size_t cacheLineSize = 128;
+#else
+  inline constexpr std::size_t cacheLineSize = 64;
+#endif
+
+  static_assert((cacheLineSize & (cacheLineSize - 1)) == 0, "The cache line size must be a power of 2");
+
+  // A 'T' which starts on a cache line, and is padded up to the next line, so that no other object shares a line with it
+  template<typename T>
+  struct alignas(cacheLineSize) CacheAligned {
+    T value;
+
+    // Constructs the value from the arguments. A single 'CacheAligned' argument is left to the copy and move constructors, which would otherwise lose
+    // to this one for a non-const lvalue, and then try to construct the value from the whole 'CacheAligned'.
+    template<typename ... Args>
+      requires (!(sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, CacheAligned> && ...)))
+    constexpr explicit(sizeof...(Args) == 1) CacheAligned(Args&& ... args): value(std::forward<Args>(args)...) {}
+
+    constexpr T& operator*() { return value; }
+    constexpr const T& operator*() const { return value; }
+    constexpr T* operator->() { return &value; }
+    constexpr const T* operator->() const { return &value; }
+  };
+
+  static_assert(sizeof(CacheAligned<char>) == cacheLineSize);
+  static_assert(alignof(CacheAligned<char>) == cacheLineSize);
+
+  // A dense index of the calling thread (0, 1, 2, ...), assigned the first time the thread calls this function
+  std::size_t threadIndex();
+
+  // The number of CPUs this process may run on (see "platform.h"), which bounds the number of threads running at once
+  std::size_t hardwareThreads();
+
+  /**
+   * A fixed number of cache-aligned slots, each holding a 'T', e.g. for per-thread counters which are summed when read:
+   *
+   *   alignment::PerThread<std::atomic<long>> hits;
+   *   hits.local().fetch_add(1, std::memory_order_relaxed);   // In any thread
+   *   long total = 0;
+   *   for (const auto& h : hits) {
+   *     total += h.load(std::memory_order_relaxed);
+   *   }
+   *
+   * 'local()' returns the slot of the calling thread. Threads are assigned slots in the order in which they first call 'local()' (on any
+   * 'PerThread'), wrapping around once all slots are taken: with at least as many slots as threads, no two threads ever write to the same line.
+   * Otherwise some threads share a slot, so 'T' must then tolerate concurrent access (e.g. be atomic), as above.
+   */
+  template<typename T>
+  class PerThread {
+
+    std::unique_ptr<CacheAligned<T>[]> slots;
+    std::size_t count;
+
+    template<typename Slot>
+    class Iterator {
+
+      Slot* slot = nullptr;
+
+    public:
+
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using reference = decltype((std::declval<Slot&>().value));
+      using difference_type = std::ptrdiff_t;
+
+      Iterator() = default;
+      explicit Iterator(Slot* slot): slot(slot) {}
+
+      reference operator*() const { return slot->value; }
+
+      Iterator& operator++() { ++slot; return *this; }
+      Iterator operator++(int) { Iterator old = *this; ++slot; return old; }
+
+      bool operator==(const Iterator& other) const { return slot == other.slot; }
+    };
+
+  public:
+
+    using iterator = Iterator<CacheAligned<T>>;
+    using const_iterator = Iterator<const CacheAligned<T>>;
+
+    // Defaults to one slot per hardware thread; every slot is value-initialized
+    explicit PerThread(std::size_t slotCount = hardwareThreads()): slots(new CacheAligned<T>[slotCount]()), count(slotCount) {}
+
+    T& local() {
+      return slots[threadIndex() % count].value;
+    }
+
+    T& operator[](std::size_t i) {
+      return slots[i].value;
+    }
+
+    const T& operator[](std::size_t i) const {
+      return slots[i].value;
+    }
+
+    std::size_t size() const {
+      return count;
+    }
+
+    iterator begin() { return iterator(slots.get()); }
+    iterator end() { return iterator(slots.get() + count); }
+    const_iterator begin() const { return const_iterator(slots.get()); }
+    const_iterator end() const { return const_iterator(slots.get() + count); }
+
+  };
+
+}
+
+#endif // SPECIFIERS_CACHEALIGNED_H
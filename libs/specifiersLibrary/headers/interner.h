@@ -0,0 +1,239 @@
+#ifndef SPECIFIERS_INTERNER_H
+#define SPECIFIERS_INTERNER_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "arena.h"
+#include "specifiers.h"
+
+/**
+ * String interning: every distinct string is stored once and identified by a dense 32-bit symbol (0, 1, 2, ...). Symbols are compared and hashed as
+ * integers, and can index plain arrays, instead of comparing and hashing the characters of the strings every time.
+ *
+ * The interner copies each new string into an arena once; strings interned from literals (see 'StaticSymbols') are not copied at all. Strings are
+ * found through an open-addressing hash table with linear probing, whose slots each hold a symbol and the upper half of the hash of its string, so
+ * that almost all mismatches are rejected without looking at the string.
+ *
+ * Lookups are lock-free: 'find', 'name', and the common case of 'intern' (a string which is already interned) only perform atomic loads. Adding a
+ * string takes a lock. The slots of a new string are published only after its name, so concurrent readers either don't see it yet, or see all of it.
+ * When the table grows, the old table is retired rather than freed, since readers may still be probing it; retired tables are freed with the
+ * interner, and take at most as much memory as the current table.
+ */
+namespace interning {
+
+  struct Symbol {
+    std::uint32_t id;
+
+    friend constexpr auto operator<=>(Symbol, Symbol) = default;
+  };
+
+  namespace detail {
+
+    // Reads 'N' bytes as a little-endian integer. Constant evaluation can't reinterpret bytes, so it assembles them one at a time instead.
+    template<std::size_t N>
+    constexpr std::uint64_t load(const char* p) {
+
+      if (std::is_constant_evaluated() || std::endian::native != std::endian::little) {
+        std::uint64_t w = 0;
+        for (std::size_t b = 0; b < N; ++b) {
+          w |= std::uint64_t(static_cast<unsigned char>(p[b])) << (8 * b);
+        }
+        return w;
+      }
+
+      std::conditional_t<N == 8, std::uint64_t, std::uint32_t> w;
+      std::memcpy(&w, p, N);
+      return w;
+    }
+
+    constexpr std::uint64_t finalize(std::uint64_t x) {
+      x ^= x >> 30;
+      x *= 0xBF58476D1CE4E5B9ull;
+      x ^= x >> 27;
+      x *= 0x94D049BB133111EBull;
+      x ^= x >> 31;
+      return x;
+    }
+
+  }
+
+  // The hash used by the interner, which gives the same values at compile time and at runtime. Strings are consumed 8 bytes at a time with a single
+  // multiplication each; the last (partial) word is read as the last 8 bytes of the string, overlapping the previous word.
+  constexpr std::uint64_t hash(std::string_view s) {
+
+    const char* p = s.data();
+    const std::size_t n = s.size();
+
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+    auto step = [&h](std::uint64_t w) {
+      h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+      h ^= h >> 32;
+    };
+
+    if (n >= 8) {
+      for (std::size_t i = 0; i + 8 < n; i += 8) {
+        step(detail::load<8>(p + i));
+      }
+      step(detail::load<8>(p + n - 8));
+    } else if (n >= 4) {
+      step(detail::load<4>(p) | (detail::load<4>(p + n - 4) << 32));
+    } else if (n > 0) {
+      step(std::uint64_t(static_cast<unsigned char>(p[0])) | (std::uint64_t(static_cast<unsigned char>(p[n / 2])) << 8)
+           | (std::uint64_t(static_cast<unsigned char>(p[n - 1])) << 16));
+    }
+
+    return detail::finalize(h);
+  }
+
+  /**
+   * A set of strings interned at compile time, e.g.
+   *
+   *   constexpr StructC methodNames[] = {"GET", "PUT", "POST"};
+   *   constexpr interning::StaticSymbols methods(methodNames);
+   *   constexpr interning::Symbol put = methods["PUT"];
+   *
+   * The symbol of each string is its index. An interner constructed from the set starts with these strings, under these symbols, so symbols obtained
+   * at compile time (e.g. to use as 'case' labels) match those which the interner returns at runtime. Duplicate strings, or looking up a string which
+   * isn't in the set, are compile-time errors.
+   */
+  template<std::size_t N>
+  class StaticSymbols {
+
+    std::array<std::string_view, N> names{};
+    std::array<std::uint64_t, N> hashes{};
+
+  public:
+
+    consteval explicit StaticSymbols(const StructC (&literals)[N]) {
+
+      for (std::size_t i = 0; i < N; ++i) {
+        names[i] = literals[i].view();
+        hashes[i] = hash(names[i]);
+
+        for (std::size_t j = 0; j < i; ++j) {
+          if (names[j] == names[i]) {
+            throw "Duplicate symbol";
+          }
+        }
+      }
+    }
+
+    consteval Symbol operator[](std::string_view name) const {
+
+      for (std::size_t i = 0; i < N; ++i) {
+        if (names[i] == name) {
+          return {static_cast<std::uint32_t>(i)};
+        }
+      }
+
+      throw "Not a static symbol";
+    }
+
+    constexpr std::size_t size() const {
+      return N;
+    }
+
+    constexpr const std::string_view* data() const {
+      return names.data();
+    }
+
+    constexpr const std::uint64_t* hashData() const {
+      return hashes.data();
+    }
+
+  };
+
+  class Interner {
+
+    struct Entry {
+      std::string_view name;
+      std::uint64_t hash;
+    };
+
+    struct Table {
+      std::size_t mask;
+      std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+
+      explicit Table(std::size_t capacity): mask(capacity - 1), slots(new std::atomic<std::uint64_t>[capacity]()) {}
+    };
+
+    // Entries are stored in chunks which never move: chunk k holds the entries of symbols [64 * (2^k - 1), 64 * (2^(k + 1) - 1))
+    static constexpr std::size_t firstChunk = 64;
+    static constexpr std::size_t chunkCount = 27;
+
+    std::atomic<Entry*> chunks[chunkCount] = {};
+    std::atomic<Table*> table;
+    std::atomic<std::uint32_t> count = 0;
+
+    // Only used while holding the lock
+    std::mutex lock;
+    arena::Arena strings;
+    std::vector<std::unique_ptr<Table>> tables;
+    std::vector<std::unique_ptr<Entry[]>> ownedChunks;
+
+    const Entry& entry(std::uint32_t id) const;
+
+    std::optional<Symbol> find(std::string_view s, std::uint64_t h) const;
+
+    // Requires the lock; 'copy' is false for strings with static storage duration
+    Symbol add(std::string_view s, std::uint64_t h, bool copy);
+
+    void insert(Table& t, std::uint32_t id, std::uint64_t h);
+
+    void seed(const std::string_view* names, const std::uint64_t* hashes, std::size_t n);
+
+  public:
+
+    Interner();
+
+    template<std::size_t N>
+    explicit Interner(const StaticSymbols<N>& predefined): Interner() {
+      seed(predefined.data(), predefined.hashData(), N);
+    }
+
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    ~Interner();
+
+    // Returns the symbol of 's', interning it if necessary
+    Symbol intern(std::string_view s);
+
+    // Returns the symbol of 's', if it's interned
+    std::optional<Symbol> find(std::string_view s) const {
+      return find(s, hash(s));
+    }
+
+    // Returns the interned string of a symbol returned by this interner; the string lives as long as the interner
+    std::string_view name(Symbol symbol) const {
+      return entry(symbol.id).name;
+    }
+
+    std::size_t size() const {
+      return count.load(std::memory_order_acquire);
+    }
+
+  };
+
+}
+
+template<>
+struct std::hash<interning::Symbol> {
+  std::size_t operator()(interning::Symbol s) const noexcept {
+    return s.id;
+  }
+};
+
+#endif // SPECIFIERS_INTERNER_H
@@ -0,0 +1,144 @@
+#ifndef SPECIFIERS_LOOKUPTABLES_H
+#define SPECIFIERS_LOOKUPTABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * Lookup tables generated at compile time. The generators are 'consteval', so they can only ever run in the compiler; the tables which they produce
+ * are 'constinit', so the compiler rejects the program if any of them would require dynamic initialization. The tables are therefore stored in the
+ * read-only data of the binary, fully computed, and cost nothing at startup.
+ *
+ * The generators may be used to build further tables, e.g. 'constexpr auto squares = tables::generate<int, 16>([](std::size_t i) { return i * i; });'
+ */
+namespace tables {
+
+  // Returns the table of 'f(0)', 'f(1)', ..., 'f(N - 1)'
+  template<typename T, std::size_t N, typename F>
+  consteval std::array<T, N> generate(F f) {
+
+    std::array<T, N> table{};
+    for (std::size_t i = 0; i < N; ++i) {
+      table[i] = static_cast<T>(f(i));
+    }
+
+    return table;
+  }
+
+  // n! for every n whose factorial fits in 64 bits
+  consteval std::array<std::uint64_t, 21> generateFactorials() {
+
+    std::array<std::uint64_t, 21> table{};
+    table[0] = 1;
+    for (std::size_t n = 1; n < table.size(); ++n) {
+      table[n] = table[n - 1] * n;
+    }
+
+    return table;
+  }
+
+  // Pascal's triangle: 'table[n][k]' is 'n choose k' (zero for k > n). Row 67 is the last one in which every coefficient fits in 64 bits.
+  template<std::size_t N>
+  consteval std::array<std::array<std::uint64_t, N>, N> generateBinomials() {
+
+    static_assert(N <= 68, "Binomial coefficients overflow");
+
+    std::array<std::array<std::uint64_t, N>, N> table{};
+    for (std::size_t n = 0; n < N; ++n) {
+      table[n][0] = 1;
+      for (std::size_t k = 1; k <= n; ++k) {
+        table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
+      }
+    }
+
+    return table;
+  }
+
+  // The table of the byte-at-a-time CRC-32 algorithm, for the given (reflected) polynomial
+  consteval std::array<std::uint32_t, 256> generateCrc32(std::uint32_t polynomial) {
+
+    return generate<std::uint32_t, 256>([polynomial](std::size_t i) {
+      auto crc = static_cast<std::uint32_t>(i);
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+      }
+      return crc;
+    });
+  }
+
+  consteval std::array<std::uint8_t, 256> generatePopcounts() {
+
+    return generate<std::uint8_t, 256>([](std::size_t i) {
+      int count = 0;
+      for (; i; i &= i - 1) {
+        ++count;
+      }
+      return count;
+    });
+  }
+
+  consteval std::array<std::uint8_t, 256> generateBitReversals() {
+
+    return generate<std::uint8_t, 256>([](std::size_t i) {
+      std::size_t reversed = 0;
+      for (int bit = 0; bit < 8; ++bit) {
+        reversed |= ((i >> bit) & 1) << (7 - bit);
+      }
+      return reversed;
+    });
+  }
+
+  // The polynomial of the CRC-32 used by zlib, PNG, Ethernet, etc.
+  constexpr std::uint32_t crc32Polynomial = 0xEDB88320;
+
+  extern constinit const std::array<std::uint64_t, 21> factorialTable;
+  extern constinit const std::array<std::array<std::uint64_t, 64>, 64> binomialTable;
+  extern constinit const std::array<std::uint32_t, 256> crc32Table;
+  extern constinit const std::array<std::uint8_t, 256> popcountTable;
+  extern constinit const std::array<std::uint8_t, 256> bitReversalTable;
+
+  // n <= 20
+  inline std::uint64_t factorial(unsigned n) {
+    return factorialTable[n];
+  }
+
+  // n < 64
+  inline std::uint64_t binomial(unsigned n, unsigned k) {
+    return binomialTable[n][k];
+  }
+
+  inline std::uint32_t crc32(std::span<const std::uint8_t> data, std::uint32_t crc = 0) {
+
+    crc = ~crc;
+    for (std::uint8_t byte : data) {
+      crc = crc32Table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+  }
+
+  inline unsigned popcount(std::uint64_t x) {
+
+    unsigned count = 0;
+    for (int byte = 0; byte < 8; ++byte, x >>= 8) {
+      count += popcountTable[x & 0xFF];
+    }
+
+    return count;
+  }
+
+  inline std::uint64_t reverseBits(std::uint64_t x) {
+
+    std::uint64_t reversed = 0;
+    for (int byte = 0; byte < 8; ++byte, x >>= 8) {
+      reversed = (reversed << 8) | bitReversalTable[x & 0xFF];
+    }
+
+    return reversed;
+  }
+
+}
+
+#endif // SPECIFIERS_LOOKUPTABLES_H
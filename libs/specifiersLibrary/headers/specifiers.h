@@ -1,6 +1,9 @@
 #ifndef SPECIFIERS_SPECIFIERS_H
 #define SPECIFIERS_SPECIFIERS_H
 
+#include <cstddef>
+#include <string_view>
+
 // Default alignment of this class would be 8, since it only has a double data member and the alignment of double is 8
 struct alignas(16) Aligned {
   double d;
@@ -14,6 +17,7 @@ public:
   template<std::size_t N>
   StructA(const char(&a)[N]): p(a), size(N - 1) {}
   ~StructA() { size = 0; }
+  constexpr std::string_view view() const { return {p, size}; }
 };
 
 // Not a literal class, but it has a constexpr constructor.
@@ -24,6 +28,7 @@ public:
   template<std::size_t N>
   constexpr StructB(const char(&a)[N]): p(a), size(N - 1) {}
   ~StructB() { size = 0; }
+  constexpr std::string_view view() const { return {p, size}; }
 };
 
 // Literal class.
@@ -34,6 +39,7 @@ public:
   template<std::size_t N>
   constexpr StructC(const char(&a)[N]): p(a), size(N - 1) {}
   constexpr ~StructC() { size = 0; }
+  constexpr std::string_view view() const { return {p, size}; }
 };
 
 #endif // SPECIFIERS_SPECIFIERS_H
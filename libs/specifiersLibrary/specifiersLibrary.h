@@ -2,6 +2,10 @@
 #define SPECIFIERSIBRARY_H
 
 #include "attributes.h"
+#include "branchProfile.h"
+#include "cacheAligned.h"
+#include "interner.h"
+#include "lookupTables.h"
 #include "specifiers.h"
 
 #endif // SPECIFIERSIBRARY_H
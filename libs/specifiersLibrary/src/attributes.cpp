@@ -1,11 +1,26 @@
 #include "attributes.h"
+#include "branchProfile.h"
+#include "registry.h"
 
 int attributeExample [[deprecated]] (int x) {
+  BRANCH_DECISION(attributeSwitch);
   switch (x) {
     case 99: [[fallthrough]];
-    case 100: [[unlikely]];
+    case 100: BRANCH_UNLIKELY(attributeSwitch);
       return 0;
-    default: [[likely]];
+    default: BRANCH_LIKELY(attributeSwitch);
       return (x - 1);
   }
 }
+
+// Calls the deprecated function on purpose, with mostly ordinary arguments, so that its hints can be checked (see "branchProfile.h")
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+void attributeHints() {
+  for (int x = 0; x < 1000; ++x) {
+    static_cast<void>(attributeExample(x % 200));
+  }
+}
+#pragma GCC diagnostic pop
+
+REGISTER_EXAMPLE("specifiers/attributeHints", attributeHints);
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+
+#include "branchProfile.h"
+
+namespace branches {
+
+  namespace {
+
+    struct Registry {
+      std::mutex lock;
+      std::vector<Site*> sites;
+    };
+
+    // Constructed by the first site, and never destroyed, so that it outlives every site. With BRANCH_PROFILING, the sites of the macros are never
+    // destroyed either, so they can all still be reported at exit.
+    Registry& registry() {
+      static Registry* r = [] {
+#if defined(BRANCH_PROFILING)
+        std::atexit([] { report(std::cerr); });
+#endif
+        return new Registry();
+      }();
+      return *r;
+    }
+
+    const char* hintName(Hint hint) {
+      return (hint == Hint::likely) ? "likely" : "unlikely";
+    }
+
+  }
+
+  Site::Site(std::string_view decision, std::string_view function, std::string_view file, int line, Hint hint, const Site* decisionSite):
+      decision(decision), function(function), file(file), line(line), hint(hint), decisionSite(decisionSite) {
+
+    Registry& r = registry();
+    std::lock_guard guard(r.lock);
+    r.sites.push_back(this);
+  }
+
+  Site::~Site() {
+    Registry& r = registry();
+    std::lock_guard guard(r.lock);
+    r.sites.erase(std::find(r.sites.begin(), r.sites.end(), this));
+  }
+
+  std::uint64_t Site::hits() const {
+    std::uint64_t total = 0;
+    for (const auto& count : counts) {
+      total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  void Site::reset() {
+    for (auto& count : counts) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<BranchReport> collect() {
+
+    Registry& r = registry();
+    std::lock_guard guard(r.lock);
+
+    std::vector<BranchReport> reports;
+    for (const Site* site : r.sites) {
+      if (!site->decisionSite) {
+        continue;
+      }
+
+      BranchReport report{site, site->decisionSite->hits(), site->hits(), 0, false};
+      if (report.decisions) {
+        report.ratio = static_cast<double>(report.hits) / static_cast<double>(report.decisions);
+        report.contradictsHint = (site->hint == Hint::likely) ? (report.ratio < contradictionThreshold) : (report.ratio > contradictionThreshold);
+      }
+      reports.push_back(report);
+    }
+
+    std::sort(reports.begin(), reports.end(), [](const BranchReport& a, const BranchReport& b) {
+      return std::tie(a.branch->file, a.branch->line) < std::tie(b.branch->file, b.branch->line);
+    });
+    return reports;
+  }
+
+  void report(std::ostream& out) {
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    for (const BranchReport& r : collect()) {
+      out << r.branch->file << ':' << r.branch->line << " (" << r.branch->function << ", " << r.branch->decision << "): "
+          << hintName(r.branch->hint) << ", taken " << r.hits;
+
+      if (r.decisions) {
+        out << " of " << r.decisions << " (" << std::fixed << std::setprecision(1) << 100 * r.ratio << "%)";
+      } else {
+        out << " times (no decision counted)";
+      }
+
+      if (r.contradictsHint) {
+        out << " <- contradicts hint";
+      }
+      out << '\n';
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  void reset() {
+
+    Registry& r = registry();
+    std::lock_guard guard(r.lock);
+    for (Site* site : r.sites) {
+      site->reset();
+    }
+  }
+
+}
@@ -0,0 +1,37 @@
+#include <atomic>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "cacheAligned.h"
+#include "platform.h"
+
+namespace alignment {
+
+  namespace {
+
+    std::atomic<std::size_t> nextThreadIndex = 0;
+
+    // Copying a non-const 'CacheAligned' (or a slot of a 'PerThread', whose slots are 'CacheAligned') must use the copy constructor, not the
+    // forwarding constructor
+    static_assert([] {
+      CacheAligned<std::string> a(3, 'a');
+      CacheAligned<std::string> b(a);
+      CacheAligned<std::string> c(std::move(b));
+      c = a;
+      return *c;
+    }() == "aaa");
+    static_assert(!std::is_convertible_v<std::string&, CacheAligned<std::string>>);
+
+  }
+
+  std::size_t threadIndex() {
+    thread_local const std::size_t index = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  std::size_t hardwareThreads() {
+    return platform::availableCpus();
+  }
+
+}
@@ -0,0 +1,127 @@
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#include "interner.h"
+
+namespace interning {
+
+  namespace {
+
+    constexpr std::uint64_t tagMask = 0xFFFFFFFF00000000ull;
+
+  }
+
+  Interner::Interner() {
+    tables.push_back(std::make_unique<Table>(64));
+    table.store(tables.back().get(), std::memory_order_release);
+  }
+
+  Interner::~Interner() = default;
+
+  const Interner::Entry& Interner::entry(std::uint32_t id) const {
+
+    std::size_t k = std::bit_width(id / firstChunk + 1) - 1;
+    std::size_t offset = id - firstChunk * ((std::size_t(1) << k) - 1);
+
+    return chunks[k].load(std::memory_order_acquire)[offset];
+  }
+
+  std::optional<Symbol> Interner::find(std::string_view s, std::uint64_t h) const {
+
+    const Table* t = table.load(std::memory_order_acquire);
+
+    for (std::size_t i = h & t->mask;; i = (i + 1) & t->mask) {
+      std::uint64_t slot = t->slots[i].load(std::memory_order_acquire);
+
+      if (slot == 0) {
+        return std::nullopt;
+      }
+
+      if ((slot & tagMask) == (h & tagMask)) {
+        auto id = static_cast<std::uint32_t>(slot) - 1;
+        if (entry(id).name == s) {
+          return Symbol{id};
+        }
+      }
+    }
+  }
+
+  void Interner::insert(Table& t, std::uint32_t id, std::uint64_t h) {
+
+    std::size_t i = h & t.mask;
+    while (t.slots[i].load(std::memory_order_relaxed) != 0) {
+      i = (i + 1) & t.mask;
+    }
+
+    // Publishes the entry of the symbol, which was written before
+    t.slots[i].store((h & tagMask) | (std::uint64_t(id) + 1), std::memory_order_release);
+  }
+
+  Symbol Interner::add(std::string_view s, std::uint64_t h, bool copy) {
+
+    std::uint32_t id = count.load(std::memory_order_relaxed);
+    assert(id < 0xFFFFFFFF && "Out of symbols");
+
+    std::size_t k = std::bit_width(id / firstChunk + 1) - 1;
+    std::size_t offset = id - firstChunk * ((std::size_t(1) << k) - 1);
+
+    Entry* chunk = chunks[k].load(std::memory_order_relaxed);
+    if (!chunk) {
+      ownedChunks.push_back(std::make_unique<Entry[]>(firstChunk << k));
+      chunk = ownedChunks.back().get();
+      chunks[k].store(chunk, std::memory_order_release);
+    }
+
+    if (copy && !s.empty()) {
+      auto* p = static_cast<char*>(strings.allocate(s.size(), 1));
+      std::memcpy(p, s.data(), s.size());
+      s = {p, s.size()};
+    }
+    chunk[offset] = {s, h};
+
+    // The table is kept at most half full, so that probe sequences stay short
+    Table* t = table.load(std::memory_order_relaxed);
+    if (2 * (std::size_t(id) + 1) > t->mask + 1) {
+      auto bigger = std::make_unique<Table>(2 * (t->mask + 1));
+      for (std::uint32_t j = 0; j < id; ++j) {
+        insert(*bigger, j, entry(j).hash);
+      }
+
+      t = bigger.get();
+      tables.push_back(std::move(bigger));
+      table.store(t, std::memory_order_release);
+    }
+
+    insert(*t, id, h);
+    count.store(id + 1, std::memory_order_release);
+
+    return {id};
+  }
+
+  void Interner::seed(const std::string_view* names, const std::uint64_t* hashes, std::size_t n) {
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (std::size_t i = 0; i < n; ++i) {
+      add(names[i], hashes[i], false);
+    }
+  }
+
+  Symbol Interner::intern(std::string_view s) {
+
+    std::uint64_t h = hash(s);
+    if (auto found = find(s, h)) {
+      return *found;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    // Another thread may have added the string since the lock-free lookup
+    if (auto found = find(s, h)) {
+      return *found;
+    }
+
+    return add(s, h, true);
+  }
+
+}
@@ -0,0 +1,35 @@
+#include "lookupTables.h"
+
+namespace tables {
+
+  // 'constinit' makes it an error for any of these tables to be initialized at runtime, so that none of them adds to the startup cost of the program
+  constinit const std::array<std::uint64_t, 21> factorialTable = generateFactorials();
+  constinit const std::array<std::array<std::uint64_t, 64>, 64> binomialTable = generateBinomials<64>();
+  constinit const std::array<std::uint32_t, 256> crc32Table = generateCrc32(crc32Polynomial);
+  constinit const std::array<std::uint8_t, 256> popcountTable = generatePopcounts();
+  constinit const std::array<std::uint8_t, 256> bitReversalTable = generateBitReversals();
+
+  namespace {
+
+    // The table-driven algorithm, evaluated entirely by the compiler
+    consteval std::uint32_t crc32Of(const char* data) {
+
+      const auto table = generateCrc32(crc32Polynomial);
+
+      std::uint32_t crc = ~std::uint32_t(0);
+      for (; *data; ++data) {
+        crc = table[(crc ^ static_cast<std::uint8_t>(*data)) & 0xFF] ^ (crc >> 8);
+      }
+
+      return ~crc;
+    }
+
+  }
+
+  static_assert(generateFactorials()[20] == 2432902008176640000ull);
+  static_assert(generateBinomials<64>()[63][31] == 916312070471295267ull);
+  static_assert(crc32Of("123456789") == 0xCBF43926);
+  static_assert(generatePopcounts()[0xFF] == 8 && generatePopcounts()[0x96] == 4);
+  static_assert(generateBitReversals()[0x01] == 0x80 && generateBitReversals()[0x96] == 0x69);
+
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 
+#include "lookupTables.h"
 #include "specifiers.h"
 
 namespace specifiers {
@@ -22,6 +23,12 @@ namespace specifiers {
     return (n <= 1) ? 1 : (n * factorialB(n - 1));
   }
   
+  // Every call above computes a single value. Tables of values can be generated at compile time in the same way, and used at runtime at the cost of a
+  // memory access; 13! doesn't fit in an int, so both tables end at 12!.
+  constinit const auto factorialsA = tables::generate<int, 13>(factorialA);
+  // A consteval function can only be called from another immediate function, hence the consteval lambda
+  constinit const auto factorialsB = tables::generate<int, 13>([](std::size_t n) consteval { return factorialB(static_cast<int>(n)); });
+  
   // Not a literal class and no constexpr constructor, therefore cannot be either constant initialized or constant destroyed (therefore compile-time
   // replaced).
   //constinit StructA x1 = StructA("Test");
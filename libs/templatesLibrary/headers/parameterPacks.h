@@ -5,7 +5,7 @@
  * The class and function templates below demonstrate the different possible uses for parameter pack expansion.
  */
 
-// Template parameter list
+// Template parameter list (see "soaVector.h" for a container which stores one column for each type in such a list)
 template<class ... Types>
 struct Tuple {
   
@@ -34,7 +34,7 @@ void f(bool b, Types ... args) {
 template <int ... numbers>
 struct Demo {
 
-  // Fold expressions
+  // Fold expressions (see "reductions.h" for their runtime counterpart, which folds a pack of reductions into a single pass over a range)
   int sum = (numbers + ... + 0);
   int truth = (... && numbers);
 
@@ -0,0 +1,262 @@
+#ifndef TEMPLATES_REDUCTIONS_H
+#define TEMPLATES_REDUCTIONS_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * The runtime counterpart of the fold expressions in "parameterPacks.h": 'reduce(range, reducers...)' computes every reduction in the pack
+ * 'reducers' (e.g. sum, min, max, variance) in a single pass over 'range', and returns their results as a tuple:
+ *
+ *   auto [sum, min, max, variance] = templates::reduce(values, Sum{}, Min{}, Max{}, Variance{});
+ *
+ * The pack of reducers is expanded into the body of one loop, so every element is loaded once and fed to all reducers while it is in a register.
+ * Computing each statistic with its own loop instead multiplies the memory traffic by the number of statistics.
+ *
+ * Each reducer keeps 'Lanes' independent accumulators, and consecutive elements go to consecutive lanes. A single accumulator forms a chain of
+ * dependent operations (each addition must wait for the previous one), which is bound by the latency of the operation; independent lanes execute in
+ * parallel. The lanes are merged at the end, so floating-point results may differ from those of a sequential loop by rounding.
+ *
+ * A reducer is any type with a member function template 'accumulator<T>(const T& first)', which returns an accumulator for elements of type 'T',
+ * given the first element of the range (or a value-initialized 'T' if the range is empty). An accumulator has the member functions 'add(element)',
+ * 'merge(other)', and 'result()'.
+ */
+namespace templates {
+
+  // Integers are summed in 64 bits; floating-point numbers in their own type
+  struct Sum {
+
+    template<typename T>
+    struct Accumulator {
+      using Result = std::conditional_t<std::is_integral_v<T>, std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>, T>;
+
+      Result total = 0;
+
+      void add(const T& x) { total += x; }
+      void merge(const Accumulator& other) { total += other.total; }
+      Result result() const { return total; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {}; }
+  };
+
+  // The minimum of an empty range is the maximum value of the type (or infinity)
+  struct Min {
+
+    template<typename T>
+    struct Accumulator {
+      T value = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+
+      void add(const T& x) { value = x < value ? x : value; }
+      void merge(const Accumulator& other) { add(other.value); }
+      T result() const { return value; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {}; }
+  };
+
+  // The maximum of an empty range is the lowest value of the type (or negative infinity)
+  struct Max {
+
+    template<typename T>
+    struct Accumulator {
+      T value = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+
+      void add(const T& x) { value = value < x ? x : value; }
+      void merge(const Accumulator& other) { add(other.value); }
+      T result() const { return value; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {}; }
+  };
+
+  struct Count {
+
+    template<typename T>
+    struct Accumulator {
+      std::size_t n = 0;
+
+      void add(const T&) { ++n; }
+      void merge(const Accumulator& other) { n += other.n; }
+      std::size_t result() const { return n; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {}; }
+  };
+
+  // Number of elements which satisfy the predicate
+  template<typename P>
+  struct CountIf {
+    P predicate;
+
+    template<typename T>
+    struct Accumulator {
+      P predicate;
+      std::size_t n = 0;
+
+      void add(const T& x) { n += static_cast<bool>(predicate(x)); }
+      void merge(const Accumulator& other) { n += other.n; }
+      std::size_t result() const { return n; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {predicate}; }
+  };
+
+  // Whether any element satisfies the predicate. Every element is still visited, since the other reducers need them.
+  template<typename P>
+  struct Any {
+    P predicate;
+
+    template<typename T>
+    struct Accumulator {
+      P predicate;
+      bool found = false;
+
+      void add(const T& x) { found |= static_cast<bool>(predicate(x)); }
+      void merge(const Accumulator& other) { found |= other.found; }
+      bool result() const { return found; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {predicate}; }
+  };
+
+  // Whether all elements satisfy the predicate (true for an empty range)
+  template<typename P>
+  struct All {
+    P predicate;
+
+    template<typename T>
+    struct Accumulator {
+      P predicate;
+      bool holds = true;
+
+      void add(const T& x) { holds &= static_cast<bool>(predicate(x)); }
+      void merge(const Accumulator& other) { holds &= other.holds; }
+      bool result() const { return holds; }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T&) const { return {predicate}; }
+  };
+
+  namespace detail {
+
+    // Sums of the elements and of their squares, shifted by the first element. Shifting avoids the catastrophic cancellation of the naive
+    // "sum of squares minus square of sum" formula when the values are large relative to their spread, without the division per element of
+    // Welford's algorithm.
+    template<typename T>
+    struct Moments {
+      double shift;
+      double sum = 0;
+      double squares = 0;
+      std::size_t n = 0;
+
+      void add(const T& x) {
+        double d = static_cast<double>(x) - shift;
+        sum += d;
+        squares += d * d;
+        ++n;
+      }
+
+      void merge(const Moments& other) {
+        sum += other.sum;
+        squares += other.squares;
+        n += other.n;
+      }
+    };
+
+  }
+
+  // The mean of an empty range is NaN
+  struct Mean {
+
+    template<typename T>
+    struct Accumulator : detail::Moments<T> {
+      double result() const { return this->n ? this->shift + this->sum / this->n : std::nan(""); }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T& first) const { return {{static_cast<double>(first)}}; }
+  };
+
+  // The population variance; the variance of an empty range is NaN
+  struct Variance {
+
+    template<typename T>
+    struct Accumulator : detail::Moments<T> {
+      double result() const { return this->n ? (this->squares - this->sum * this->sum / this->n) / this->n : std::nan(""); }
+    };
+
+    template<typename T>
+    Accumulator<T> accumulator(const T& first) const { return {{static_cast<double>(first)}}; }
+  };
+
+  template<std::size_t Lanes = 4, std::ranges::input_range R, typename ... Reducers>
+  auto reduce(R&& range, const Reducers& ... reducers) {
+
+    static_assert(Lanes > 0, "At least one lane is needed");
+
+    using T = std::ranges::range_value_t<R>;
+    using Laned = std::tuple<std::array<decltype(reducers.accumulator(std::declval<const T&>())), Lanes>...>;
+
+    auto first = std::ranges::begin(range);
+    auto last = std::ranges::end(range);
+    const T hint = (first != last) ? T(*first) : T{};
+
+    auto laned = [&hint]<std::size_t ... L>(const auto& reducer, std::index_sequence<L...>) {
+      return std::array{((void) L, reducer.accumulator(hint))...};
+    };
+    Laned lanes{laned(reducers, std::make_index_sequence<Lanes>{})...};
+
+    // Feeds one element to lane 'L' of every reducer
+    auto add = [&lanes]<std::size_t L>(std::integral_constant<std::size_t, L>, const T& x) {
+      std::apply([&x](auto& ... accumulators) { (accumulators[L].add(x), ...); }, lanes);
+    };
+
+    if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>) {
+      const std::size_t n = std::ranges::size(range);
+      std::size_t i = 0;
+
+      for (; i + Lanes <= n; i += Lanes) {
+        [&]<std::size_t ... L>(std::index_sequence<L...>) {
+          (add(std::integral_constant<std::size_t, L>{}, first[i + L]), ...);
+        }(std::make_index_sequence<Lanes>{});
+      }
+      for (; i < n; ++i) {
+        add(std::integral_constant<std::size_t, 0>{}, first[i]);
+      }
+
+    } else {
+      for (; first != last; ++first) {
+        add(std::integral_constant<std::size_t, 0>{}, *first);
+      }
+    }
+
+    return std::apply([](auto& ... accumulators) {
+      ([&] {
+        for (std::size_t l = 1; l < Lanes; ++l) {
+          accumulators[0].merge(accumulators[l]);
+        }
+      }(), ...);
+
+      return std::tuple(accumulators[0].result()...);
+    }, lanes);
+  }
+
+}
+
+#endif // TEMPLATES_REDUCTIONS_H
@@ -0,0 +1,248 @@
+#ifndef TEMPLATES_SOAVECTOR_H
+#define TEMPLATES_SOAVECTOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A sequence of rows, each made of one value of every type in 'Types', stored as a "structure of arrays" (SoA): each field is stored in its own
+ * contiguous array (column), rather than each row being stored contiguously (an "array of structures", AoS, e.g. 'std::vector<std::tuple<...>>').
+ *
+ * Scanning one field of an AoS loads every field of every row into the cache, most of which is never used. Scanning one column of a SoA only loads
+ * that field, and the column is a plain array which the compiler can vectorize. Every column starts on a 64-byte boundary, which is the size of a
+ * cache line and of an AVX-512 register.
+ *
+ * All columns live in a single allocation, which grows geometrically like that of 'std::vector'. Rows are accessed through tuple-like proxies
+ * ('std::tuple' of references), so that e.g. 'auto [price, quantity] = v[i];' binds references to the fields of row 'i'; columns are accessed as
+ * spans.
+ *
+ * Growing moves the elements into the new allocation, so all types must be nothrow move constructible. Growing invalidates all proxies, spans, and
+ * iterators.
+ */
+namespace templates {
+
+  template<typename ... Types>
+  class SoAVector {
+
+    static_assert(sizeof...(Types) > 0, "A SoAVector needs at least one column");
+    static_assert((std::is_nothrow_move_constructible_v<Types> && ...), "Elements are moved when the SoAVector grows");
+
+    static constexpr std::size_t alignment = 64;
+
+    using Indices = std::index_sequence_for<Types...>;
+
+    template<std::size_t I>
+    using Column = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    std::tuple<Types*...> columns{};
+    std::size_t count = 0;
+    std::size_t allocated = 0;
+
+    static std::size_t columnBytes(std::size_t capacity, std::size_t size) {
+      return (capacity * size + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Columns are laid out one after another in the order of 'Types'; the first column is the start of the allocation
+    template<std::size_t ... I>
+    void reallocate(std::size_t capacity, std::index_sequence<I...>) {
+
+      std::size_t bytes = (columnBytes(capacity, sizeof(Types)) + ...);
+      auto* start = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(alignment)));
+
+      std::tuple<Types*...> moved;
+      std::byte* p = start;
+      ((std::get<I>(moved) = reinterpret_cast<Types*>(p), p += columnBytes(capacity, sizeof(Types))), ...);
+
+      (std::uninitialized_move_n(std::get<I>(columns), count, std::get<I>(moved)), ...);
+      release();
+
+      columns = moved;
+      allocated = capacity;
+    }
+
+    void release() {
+
+      if (allocated) {
+        std::apply([this](Types* ... column) { (std::destroy_n(column, count), ...); }, columns);
+        ::operator delete(static_cast<void*>(std::get<0>(columns)), std::align_val_t(alignment));
+      }
+    }
+
+    void grow() {
+      reserve(allocated ? 2 * allocated : 16);
+    }
+
+    template<bool Const>
+    class Iterator {
+
+      using Owner = std::conditional_t<Const, const SoAVector, SoAVector>;
+
+      Owner* v = nullptr;
+      std::size_t i = 0;
+
+    public:
+
+      using iterator_category = std::input_iterator_tag;
+      using value_type = std::tuple<Types...>;
+      using reference = decltype(std::declval<Owner&>()[0]);
+      using difference_type = std::ptrdiff_t;
+
+      Iterator() = default;
+      Iterator(Owner* v, std::size_t i): v(v), i(i) {}
+
+      reference operator*() const { return (*v)[i]; }
+
+      Iterator& operator++() { ++i; return *this; }
+      Iterator operator++(int) { Iterator old = *this; ++i; return old; }
+
+      Iterator& operator+=(difference_type n) { i += n; return *this; }
+      Iterator operator+(difference_type n) const { return Iterator(v, i + n); }
+      difference_type operator-(const Iterator& other) const { return difference_type(i) - difference_type(other.i); }
+
+      bool operator==(const Iterator& other) const { return i == other.i; }
+    };
+
+  public:
+
+    using value_type = std::tuple<Types...>;
+    using reference = std::tuple<Types&...>;
+    using const_reference = std::tuple<const Types&...>;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SoAVector() = default;
+
+    // Delegates to the default constructor, so that the rows copied so far are destroyed if a copy throws
+    SoAVector(const SoAVector& other): SoAVector() {
+
+      reserve(other.count);
+      for (std::size_t i = 0; i < other.count; ++i) {
+        std::apply([this](const Types& ... values) { push_back(values...); }, other[i]);
+      }
+    }
+
+    SoAVector(SoAVector&& other) noexcept:
+        columns(std::exchange(other.columns, {})),
+        count(std::exchange(other.count, 0)),
+        allocated(std::exchange(other.allocated, 0)) {}
+
+    SoAVector& operator=(SoAVector other) noexcept {
+
+      std::swap(columns, other.columns);
+      std::swap(count, other.count);
+      std::swap(allocated, other.allocated);
+
+      return *this;
+    }
+
+    ~SoAVector() {
+      release();
+    }
+
+    std::size_t size() const {
+      return count;
+    }
+
+    std::size_t capacity() const {
+      return allocated;
+    }
+
+    bool empty() const {
+      return count == 0;
+    }
+
+    void reserve(std::size_t capacity) {
+      if (capacity > allocated) {
+        reallocate(capacity, Indices{});
+      }
+    }
+
+    // The values are taken by value and then moved into place, so that a throwing copy leaves the SoAVector unchanged
+    void push_back(Types ... values) {
+
+      if (count == allocated) {
+        grow();
+      }
+
+      std::apply([&](Types* ... column) { (std::construct_at(column + count, std::move(values)), ...); }, columns);
+      ++count;
+    }
+
+    void push_back(value_type row) {
+      std::apply([this](Types& ... values) { push_back(std::move(values)...); }, row);
+    }
+
+    void pop_back() {
+
+      --count;
+      std::apply([this](Types* ... column) { (std::destroy_at(column + count), ...); }, columns);
+    }
+
+    // New rows are value-initialized
+    void resize(std::size_t size) requires (std::is_nothrow_default_constructible_v<Types> && ...) {
+
+      reserve(size);
+
+      std::apply([&](Types* ... column) {
+        if (size > count) {
+          (std::uninitialized_value_construct(column + count, column + size), ...);
+        } else {
+          (std::destroy(column + size, column + count), ...);
+        }
+      }, columns);
+
+      count = size;
+    }
+
+    void clear() {
+      std::apply([this](Types* ... column) { (std::destroy_n(column, count), ...); }, columns);
+      count = 0;
+    }
+
+    // Row proxies
+    reference operator[](std::size_t i) {
+      return std::apply([i](Types* ... column) { return reference(column[i]...); }, columns);
+    }
+
+    const_reference operator[](std::size_t i) const {
+      return std::apply([i](Types* ... column) { return const_reference(column[i]...); }, columns);
+    }
+
+    // Columns
+    template<std::size_t I>
+    std::span<Column<I>> column() {
+      return {std::get<I>(columns), count};
+    }
+
+    template<std::size_t I>
+    std::span<const Column<I>> column() const {
+      return {std::get<I>(columns), count};
+    }
+
+    // A single field
+    template<std::size_t I>
+    Column<I>& get(std::size_t i) {
+      return std::get<I>(columns)[i];
+    }
+
+    template<std::size_t I>
+    const Column<I>& get(std::size_t i) const {
+      return std::get<I>(columns)[i];
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, count); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+  };
+
+}
+
+#endif // TEMPLATES_SOAVECTOR_H
@@ -1,4 +1,5 @@
 #include "classTemplates.h"
+#include "registry.h"
 
 void classTemplateDemonstration() {
   
@@ -20,3 +21,5 @@ void classTemplateDemonstration() {
   auto b1 = T_B<T_A>();
   
 }
+
+REGISTER_EXAMPLE("templates/classTemplateDemonstration", classTemplateDemonstration);
@@ -5,6 +5,8 @@
 #include "concepts.h"
 #include "functionTemplates.h"
 #include "parameterPacks.h"
+#include "reductions.h"
+#include "soaVector.h"
 #include "variableTemplates.h"
 
 #endif // TEMPLATESLIBRARY_H
@@ -0,0 +1,391 @@
+#ifndef TYPES_ENUMREFLECTION_H
+#define TYPES_ENUMREFLECTION_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Compile-time reflection of enumerations: the enumerators of an enumeration, their names, and their range, computed entirely at compile time, e.g.
+ *
+ *   static_assert(enums::count<Colour_3> == 3);
+ *   static_assert(enums::name(Colour_3::blue) == "blue");
+ *   static_assert(enums::fromName<Colour_3>("green") == Colour_3::green);
+ *   static_assert(!enums::contiguous<Colour_3>);   // red = 0, blue = 20, green = 21
+ *
+ * C++ has no reflection of enumerations, but the compiler names template arguments in '__PRETTY_FUNCTION__': for an enumerator, the name shows the
+ * enumerator (e.g. "Colour_1::red"), while for any other value it shows a cast (e.g. "(Colour_1)7"). Instantiating a function for every value in a
+ * range therefore finds all the enumerators in that range, and their names. The range is [-128, 127] by default (clamped to the range of the
+ * underlying type), and can be changed by specializing 'enums::Range'. Enumerators outside of the range are not found, and aliases (enumerators with
+ * the same value as a previous one) are found once, under the name of the first.
+ *
+ * All results are constants: every table (the enumerators, their names, and the map from values to positions) is a 'constexpr' array in read-only
+ * memory, rather than e.g. a 'std::unordered_map' filled at startup. Converting an enumerator to its position or name is a bounds check and a load.
+ *
+ * 'EnumMap' and 'EnumSet' use the positions of enumerators to store a value per enumerator in a flat array, or a set of enumerators in a bitset.
+ */
+namespace enums {
+
+  template<typename E>
+  struct Range {
+    static constexpr int min = -128;
+    static constexpr int max = 127;
+  };
+
+  namespace detail {
+
+    // The name of enumerator 'V' (qualified, e.g. "Colour_1::red"), or an empty string if 'V' is not an enumerator
+    template<auto V>
+    constexpr std::string_view prettyName() {
+
+      std::string_view f = __PRETTY_FUNCTION__;
+#if defined(__clang__)
+      std::size_t begin = f.find("V = ") + 4;
+      std::size_t end = f.find(']', begin);
+#else
+      std::size_t begin = f.find("V = ") + 4;
+      std::size_t end = f.find_first_of(";]", begin);
+#endif
+      std::string_view name = f.substr(begin, end - begin);
+
+      return (name.empty() || name[0] == '(' || name[0] == '-' || (name[0] >= '0' && name[0] <= '9')) ? std::string_view() : name;
+    }
+
+    // The unqualified name, stored in an array of its own, since '__PRETTY_FUNCTION__' is local to its function
+    template<auto V>
+    struct NameStorage {
+
+      static constexpr std::string_view qualified = prettyName<V>();
+      static constexpr std::string_view unqualified = qualified.substr(qualified.rfind(':') == std::string_view::npos ? 0 : qualified.rfind(':') + 1);
+
+      static constexpr auto chars = [] {
+        std::array<char, unqualified.size() + 1> a{};
+        std::copy(unqualified.begin(), unqualified.end(), a.begin());
+        return a;
+      }();
+    };
+
+    template<typename E>
+    using Underlying = std::underlying_type_t<E>;
+
+    // 'to - from', computed in the unsigned counterpart of the underlying type, so that it wraps around for any two values instead of overflowing
+    template<typename E>
+    constexpr auto distance(E from, E to) {
+      using Unsigned = std::make_unsigned_t<Underlying<E>>;
+      return static_cast<Unsigned>(static_cast<Unsigned>(Underlying<E>(to)) - static_cast<Unsigned>(Underlying<E>(from)));
+    }
+
+    template<typename E>
+    constexpr long long rangeMin = std::max<long long>(Range<E>::min, std::numeric_limits<Underlying<E>>::min());
+
+    template<typename E>
+    constexpr long long rangeMax = std::min<long long>(Range<E>::max, std::numeric_limits<Underlying<E>>::max());
+
+    template<typename E>
+    constexpr std::size_t rangeSize = static_cast<std::size_t>(rangeMax<E> - rangeMin<E> + 1);
+
+    // Whether each value of the range is an enumerator
+    template<typename E, std::size_t ... I>
+    constexpr std::array<bool, sizeof...(I)> validity(std::index_sequence<I...>) {
+      return {!prettyName<static_cast<E>(rangeMin<E> + static_cast<long long>(I))>().empty()...};
+    }
+
+    template<typename E>
+    constexpr auto valid = validity<E>(std::make_index_sequence<rangeSize<E>>{});
+
+    template<typename E, std::size_t ... I>
+    constexpr std::array<std::string_view, sizeof...(I)> rangeNames(std::index_sequence<I...>) {
+      return {std::string_view(NameStorage<static_cast<E>(rangeMin<E> + static_cast<long long>(I))>::chars.data(),
+                               NameStorage<static_cast<E>(rangeMin<E> + static_cast<long long>(I))>::unqualified.size())...};
+    }
+
+  }
+
+  // The number of enumerators
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::size_t count = std::count(detail::valid<E>.begin(), detail::valid<E>.end(), true);
+
+  // The enumerators, in increasing order of value; the position of an enumerator in this array is its index
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::array<E, count<E>> values = [] {
+    std::array<E, count<E>> v{};
+    for (std::size_t i = 0, j = 0; i < detail::rangeSize<E>; ++i) {
+      if (detail::valid<E>[i]) {
+        v[j++] = static_cast<E>(detail::rangeMin<E> + static_cast<long long>(i));
+      }
+    }
+    return v;
+  }();
+
+  // The names of the enumerators, without qualification, in the same order
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::array<std::string_view, count<E>> names = [] {
+    constexpr auto all = detail::rangeNames<E>(std::make_index_sequence<detail::rangeSize<E>>{});
+    std::array<std::string_view, count<E>> n{};
+    for (std::size_t i = 0, j = 0; i < detail::rangeSize<E>; ++i) {
+      if (detail::valid<E>[i]) {
+        n[j++] = all[i];
+      }
+    }
+    return n;
+  }();
+
+  template<typename E> requires (std::is_enum_v<E> && count<E> > 0)
+  constexpr E min = values<E>.front();
+
+  template<typename E> requires (std::is_enum_v<E> && count<E> > 0)
+  constexpr E max = values<E>.back();
+
+  // Whether the enumerators are consecutive integers, so that the index of an enumerator is its distance from the first
+  template<typename E> requires std::is_enum_v<E>
+  constexpr bool contiguous = count<E> == 0 || static_cast<std::size_t>(detail::distance(values<E>.front(), values<E>.back())) + 1 == count<E>;
+
+  namespace detail {
+
+    // Maps each value of [min, max] to its index, or to 'count' if it's not an enumerator; unused if the enumerators are contiguous
+    template<typename E>
+    constexpr auto indices = [] {
+
+      constexpr std::size_t span = count<E> ? static_cast<std::size_t>(distance(min<E>, max<E>)) + 1 : 0;
+      using Index = std::conditional_t<(count<E> < 256), std::uint8_t, std::uint16_t>;
+
+      std::array<Index, span> table{};
+      table.fill(static_cast<Index>(count<E>));
+      for (std::size_t i = 0; i < count<E>; ++i) {
+        table[static_cast<std::size_t>(distance(min<E>, values<E>[i]))] = static_cast<Index>(i);
+      }
+      return table;
+    }();
+
+  }
+
+  // The index of 'e' in 'values<E>', or 'count<E>' if 'e' is not an enumerator
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::size_t index(E e) {
+
+    if constexpr (count<E> == 0) {
+      return 0;
+    } else {
+      // Values below the minimum wrap around to large offsets
+      auto offset = detail::distance(min<E>, e);
+      if constexpr (contiguous<E>) {
+        return offset < count<E> ? offset : count<E>;
+      } else {
+        return offset < detail::indices<E>.size() ? detail::indices<E>[offset] : count<E>;
+      }
+    }
+  }
+
+  template<typename E> requires std::is_enum_v<E>
+  constexpr bool isEnumerator(E e) {
+    return index(e) < count<E>;
+  }
+
+  // The name of 'e', or an empty string if 'e' is not an enumerator
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::string_view name(E e) {
+    std::size_t i = index(e);
+    return i < count<E> ? names<E>[i] : std::string_view();
+  }
+
+  template<typename E> requires std::is_enum_v<E>
+  constexpr std::optional<E> fromName(std::string_view name) {
+
+    for (std::size_t i = 0; i < count<E>; ++i) {
+      if (names<E>[i] == name) {
+        return values<E>[i];
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * A value of type 'V' for every enumerator of 'E', stored in a flat array in the order of 'values<E>': looking up an enumerator is a subtraction
+   * (or a load from 'detail::indices', if the enumerators aren't contiguous) and an array access, without hashing.
+   */
+  template<typename E, typename V>
+  class EnumMap {
+
+    std::array<V, count<E>> entries{};
+
+  public:
+
+    constexpr EnumMap() = default;
+
+    // Every enumerator maps to 'value'
+    constexpr explicit EnumMap(const V& value) {
+      entries.fill(value);
+    }
+
+    // 'e' must be an enumerator
+    constexpr V& operator[](E e) {
+      return entries[index(e)];
+    }
+
+    constexpr const V& operator[](E e) const {
+      return entries[index(e)];
+    }
+
+    constexpr V& at(E e) {
+      if (!isEnumerator(e)) {
+        throw std::out_of_range("Not an enumerator");
+      }
+      return entries[index(e)];
+    }
+
+    constexpr const V& at(E e) const {
+      if (!isEnumerator(e)) {
+        throw std::out_of_range("Not an enumerator");
+      }
+      return entries[index(e)];
+    }
+
+    static constexpr std::size_t size() {
+      return count<E>;
+    }
+
+    // The values, in the order of 'values<E>'
+    constexpr auto begin() { return entries.begin(); }
+    constexpr auto end() { return entries.end(); }
+    constexpr auto begin() const { return entries.begin(); }
+    constexpr auto end() const { return entries.end(); }
+
+    // Calls 'f(enumerator, value)' for every enumerator
+    template<typename F>
+    constexpr void forEach(F&& f) {
+      for (std::size_t i = 0; i < count<E>; ++i) {
+        f(values<E>[i], entries[i]);
+      }
+    }
+
+    template<typename F>
+    constexpr void forEach(F&& f) const {
+      for (std::size_t i = 0; i < count<E>; ++i) {
+        f(values<E>[i], entries[i]);
+      }
+    }
+
+    constexpr bool operator==(const EnumMap&) const = default;
+
+  };
+
+  // A set of enumerators of 'E', stored as a bitset with one bit per enumerator
+  template<typename E>
+  class EnumSet {
+
+    static constexpr std::size_t wordCount = (count<E> + 63) / 64;
+
+    std::array<std::uint64_t, wordCount> words{};
+
+    // The bits of the words which correspond to enumerators
+    static constexpr std::uint64_t lastWordMask = (count<E> % 64) ? (std::uint64_t(1) << (count<E> % 64)) - 1 : ~std::uint64_t(0);
+
+  public:
+
+    constexpr EnumSet() = default;
+
+    constexpr EnumSet(std::initializer_list<E> enumerators) {
+      for (E e : enumerators) {
+        insert(e);
+      }
+    }
+
+    static constexpr EnumSet all() {
+      return ~EnumSet();
+    }
+
+    // 'e' must be an enumerator
+    constexpr void insert(E e) {
+      std::size_t i = index(e);
+      words[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+
+    constexpr void erase(E e) {
+      std::size_t i = index(e);
+      words[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+    }
+
+    constexpr bool contains(E e) const {
+      std::size_t i = index(e);
+      return i < count<E> && (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    constexpr std::size_t size() const {
+      std::size_t n = 0;
+      for (std::uint64_t w : words) {
+        n += std::popcount(w);
+      }
+      return n;
+    }
+
+    constexpr bool empty() const {
+      return size() == 0;
+    }
+
+    constexpr void clear() {
+      words = {};
+    }
+
+    constexpr EnumSet& operator|=(const EnumSet& other) {
+      for (std::size_t w = 0; w < wordCount; ++w) {
+        words[w] |= other.words[w];
+      }
+      return *this;
+    }
+
+    constexpr EnumSet& operator&=(const EnumSet& other) {
+      for (std::size_t w = 0; w < wordCount; ++w) {
+        words[w] &= other.words[w];
+      }
+      return *this;
+    }
+
+    constexpr EnumSet& operator^=(const EnumSet& other) {
+      for (std::size_t w = 0; w < wordCount; ++w) {
+        words[w] ^= other.words[w];
+      }
+      return *this;
+    }
+
+    // The complement, within the enumerators of 'E'
+    constexpr EnumSet operator~() const {
+      EnumSet complement;
+      for (std::size_t w = 0; w < wordCount; ++w) {
+        complement.words[w] = ~words[w];
+      }
+      if constexpr (wordCount > 0) {
+        complement.words[wordCount - 1] &= lastWordMask;
+      }
+      return complement;
+    }
+
+    friend constexpr EnumSet operator|(EnumSet a, const EnumSet& b) { return a |= b; }
+    friend constexpr EnumSet operator&(EnumSet a, const EnumSet& b) { return a &= b; }
+    friend constexpr EnumSet operator^(EnumSet a, const EnumSet& b) { return a ^= b; }
+
+    constexpr bool operator==(const EnumSet&) const = default;
+
+    // Calls 'f(enumerator)' for every enumerator in the set, in the order of 'values<E>'
+    template<typename F>
+    constexpr void forEach(F&& f) const {
+      for (std::size_t w = 0; w < wordCount; ++w) {
+        for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) {
+          f(values<E>[64 * w + std::countr_zero(bits)]);
+        }
+      }
+    }
+
+  };
+
+}
+
+#endif // TYPES_ENUMREFLECTION_H
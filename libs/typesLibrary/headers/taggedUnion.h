@@ -0,0 +1,345 @@
+#ifndef TYPES_TAGGEDUNION_H
+#define TYPES_TAGGEDUNION_H
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace types {
+
+  namespace detail {
+
+    // The number of low bits which are always 0 in a pointer of type 'T' (0 if 'T' isn't a pointer to an object type)
+    template<typename T>
+    constexpr std::size_t spareBits = 0;
+
+    template<typename T> requires std::is_object_v<T>
+    constexpr std::size_t spareBits<T*> = std::countr_zero(alignof(T));
+
+    template<typename T>
+    constexpr std::size_t spareBits<T* const> = spareBits<T*>;
+
+    template<typename T, typename ... Ts>
+    constexpr std::size_t indexOf = [] {
+      constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+      std::size_t i = 0;
+      while (i < sizeof...(Ts) && !matches[i]) {
+        ++i;
+      }
+      return i;
+    }();
+
+  }
+
+  /**
+   * A union which knows which of its alternatives it holds (like 'std::variant'), but stores the discriminator (tag) in space which the union
+   * doesn't use, where there is any:
+   * - If every alternative is a pointer to a type aligned to at least 2^k bytes, and there are at most 2^k alternatives, the tag is stored in the k
+   *   low bits of the pointer, which are always 0. The union has the size of a pointer.
+   * - Otherwise, the tag is a byte placed right after the largest alternative. If the alternatives leave padding at the end of the union (see
+   *   'Union_1', whose largest member takes 9 of its 16 bytes), the tag takes one of those bytes, and the union doesn't grow. 'std::variant' always
+   *   places its index after the whole union.
+   *
+   * For example, on x86-64 (see "README.md"):
+   *
+   *   TaggedUnion<char, short, int, long, std::array<char, 9>>   16 bytes (std::variant: 24)
+   *   TaggedUnion<A*, B*, C*>, alignof A, B, C >= 4              8 bytes (std::variant: 16)
+   *
+   * 'visit' calls a function on the active alternative. With up to 8 alternatives, it compares the tag with each index in turn, which the compiler
+   * turns into a jump table (or into branch-free code) with the function inlined into each case; with more, it makes one indirect call through a
+   * table of function pointers, one per alternative, generated at compile time. Copying and moving an alternative which is trivially copyable is a
+   * 'memcpy' of the union; if all alternatives are, the union itself is trivially copyable.
+   *
+   * Unlike 'std::variant', a TaggedUnion can't be "valueless by exception": alternatives must be nothrow move constructible, and assignment copies
+   * the new value before replacing the old one. Alternatives must be distinct types, and are selected by their exact type.
+   *
+   * Pointers can't be accessed in place while their low bits hold the tag, so when the tag is stored in the pointer, 'get' returns the pointer by
+   * value, and 'visit' passes it by value.
+   */
+  template<typename ... Ts>
+  class TaggedUnion {
+
+    static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) <= 256, "A TaggedUnion has between 1 and 256 alternatives");
+    static_assert((std::is_nothrow_move_constructible_v<Ts> && ...), "Alternatives are moved into place after they are copied");
+    static_assert([]<std::size_t ... I>(std::index_sequence<I...>) { return ((detail::indexOf<Ts, Ts...> == I) && ...); }(std::index_sequence_for<Ts...>{}),
+                  "Alternatives are selected by type, so they must be distinct");
+
+    static constexpr std::size_t count = sizeof...(Ts);
+
+    template<std::size_t I>
+    using Alternative = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    template<typename T>
+    static constexpr std::size_t indexOf = detail::indexOf<T, Ts...>;
+
+    static constexpr std::size_t tagBits = std::bit_width(count - 1);
+
+  public:
+
+    // Whether the tag is stored in the low bits of the pointer alternatives
+    static constexpr bool tagInPointer = ((detail::spareBits<Ts> >= tagBits && std::is_pointer_v<Ts>) && ...);
+
+  private:
+
+    static constexpr bool triviallyCopyable = (std::is_trivially_copyable_v<Ts> && ...);
+    static constexpr bool triviallyDestructible = (std::is_trivially_destructible_v<Ts> && ...);
+
+    static constexpr std::size_t largest = std::max({sizeof(Ts)...});
+    static constexpr std::size_t alignment = std::max({alignof(Ts)...});
+
+    // Unions with more alternatives are visited through a table of function pointers
+    static constexpr std::size_t inlineVisitLimit = 8;
+
+    static constexpr std::uintptr_t tagMask = (std::uintptr_t(1) << tagBits) - 1;
+
+    // The tag is at offset 'largest', which is in the tail padding of the union if there is any; otherwise it takes another 'alignment' bytes
+    struct Bytes {
+      alignas(alignment) std::byte bytes[(largest + 1 + alignment - 1) / alignment * alignment];
+    };
+
+    std::conditional_t<tagInPointer, std::uintptr_t, Bytes> storage;
+
+    std::uint8_t tag() const {
+      if constexpr (tagInPointer) {
+        return static_cast<std::uint8_t>(storage & tagMask);
+      } else {
+        return static_cast<std::uint8_t>(storage.bytes[largest]);
+      }
+    }
+
+    // Constructs alternative 'I' in storage which holds no alternative
+    template<std::size_t I, typename ... Args>
+    void construct(Args&& ... args) {
+
+      if constexpr (tagInPointer) {
+        Alternative<I> p(std::forward<Args>(args)...);
+        storage = reinterpret_cast<std::uintptr_t>(p) | I;
+      } else {
+        std::construct_at(reinterpret_cast<Alternative<I>*>(storage.bytes), std::forward<Args>(args)...);
+        storage.bytes[largest] = static_cast<std::byte>(I);
+      }
+    }
+
+    template<std::size_t I>
+    Alternative<I>* address() {
+      return std::launder(reinterpret_cast<Alternative<I>*>(storage.bytes));
+    }
+
+    template<std::size_t I>
+    const Alternative<I>* address() const {
+      return std::launder(reinterpret_cast<const Alternative<I>*>(storage.bytes));
+    }
+
+    // The jump table of 'visit': entry 'I' calls 'f' on alternative 'I' of 'u'
+    template<std::size_t I, typename R, typename F, typename U>
+    static R visitAlternative(F&& f, U& u) {
+      return std::invoke(std::forward<F>(f), u.template get<I>());
+    }
+
+    // A chain of comparisons of the tag, which the compiler turns into a switch (or into branch-free code) and into which it inlines 'f'
+    template<std::size_t I, typename R, typename F, typename U>
+    static R visitFrom(F&& f, U& u) {
+      if constexpr (I + 1 == count) {
+        return std::invoke(std::forward<F>(f), u.template get<I>());
+      } else if (u.tag() == I) {
+        return std::invoke(std::forward<F>(f), u.template get<I>());
+      } else {
+        return visitFrom<I + 1, R>(std::forward<F>(f), u);
+      }
+    }
+
+    template<typename F, typename U, std::size_t ... I>
+    static decltype(auto) dispatch(F&& f, U& u, std::index_sequence<I...>) {
+
+      using R = decltype(std::invoke(std::forward<F>(f), u.template get<0>()));
+      static_assert((std::is_same_v<R, decltype(std::invoke(std::forward<F>(f), u.template get<I>()))> && ...),
+                    "The visitor must return the same type for every alternative");
+
+      if constexpr (count <= inlineVisitLimit) {
+        return visitFrom<0, R>(std::forward<F>(f), u);
+      } else {
+        static constexpr R (*table[])(F&&, U&) = {&visitAlternative<I, R, F, U>...};
+        return table[u.tag()](std::forward<F>(f), u);
+      }
+    }
+
+    template<std::size_t I, typename Source>
+    static void constructAlternative(TaggedUnion& self, Source&& source) {
+      if constexpr (std::is_rvalue_reference_v<Source&&>) {
+        self.template construct<I>(std::move(*source.template address<I>()));
+      } else {
+        self.template construct<I>(*source.template address<I>());
+      }
+    }
+
+    template<std::size_t I>
+    static void destroyAlternative(TaggedUnion& self) {
+      std::destroy_at(self.template address<I>());
+    }
+
+    // Copies (or moves, if 'source' is an rvalue) the alternative of 'source' into storage which holds no alternative
+    template<typename Source, std::size_t ... I>
+    void constructFrom(Source&& source, std::index_sequence<I...>) {
+
+      static constexpr bool trivial[] = {std::is_trivially_copyable_v<Ts>...};
+      if (trivial[source.tag()]) {
+        std::memcpy(&storage, &source.storage, sizeof(storage));
+        return;
+      }
+
+      static constexpr void (*table[])(TaggedUnion&, Source&&) = {&constructAlternative<I, Source>...};
+      table[source.tag()](*this, std::forward<Source>(source));
+    }
+
+    template<std::size_t ... I>
+    void destroy(std::index_sequence<I...>) {
+
+      if constexpr (!triviallyDestructible) {
+        static constexpr void (*table[])(TaggedUnion&) = {&destroyAlternative<I>...};
+        table[tag()](*this);
+      }
+    }
+
+    template<typename Source>
+    void constructFrom(Source&& source) {
+      constructFrom(std::forward<Source>(source), std::index_sequence_for<Ts...>{});
+    }
+
+    void destroy() {
+      destroy(std::index_sequence_for<Ts...>{});
+    }
+
+  public:
+
+    // Holds a value-initialized first alternative, like 'std::variant'
+    TaggedUnion() requires std::is_default_constructible_v<Alternative<0>> {
+      construct<0>();
+    }
+
+    template<typename T, typename ... Args>
+    explicit TaggedUnion(std::in_place_type_t<T>, Args&& ... args) {
+      static_assert(indexOf<T> < count, "Not an alternative");
+      construct<indexOf<T>>(std::forward<Args>(args)...);
+    }
+
+    template<typename T> requires (indexOf<std::remove_cvref_t<T>> < count)
+    TaggedUnion(T&& value) {
+      construct<indexOf<std::remove_cvref_t<T>>>(std::forward<T>(value));
+    }
+
+    TaggedUnion(const TaggedUnion&) requires triviallyCopyable = default;
+    TaggedUnion(const TaggedUnion& other) {
+      constructFrom(other);
+    }
+
+    TaggedUnion(TaggedUnion&&) requires triviallyCopyable = default;
+    TaggedUnion(TaggedUnion&& other) noexcept {
+      constructFrom(std::move(other));
+    }
+
+    TaggedUnion& operator=(const TaggedUnion&) requires triviallyCopyable = default;
+    TaggedUnion& operator=(const TaggedUnion& other) {
+
+      if (this != &other) {
+        TaggedUnion copy(other);
+        destroy();
+        constructFrom(std::move(copy));
+      }
+
+      return *this;
+    }
+
+    TaggedUnion& operator=(TaggedUnion&&) requires triviallyCopyable = default;
+    TaggedUnion& operator=(TaggedUnion&& other) noexcept {
+
+      if (this != &other) {
+        destroy();
+        constructFrom(std::move(other));
+      }
+
+      return *this;
+    }
+
+    ~TaggedUnion() requires triviallyDestructible = default;
+    ~TaggedUnion() {
+      destroy();
+    }
+
+    // Replaces the alternative with a 'T' constructed from 'args'
+    template<typename T, typename ... Args>
+    void emplace(Args&& ... args) {
+
+      static_assert(indexOf<T> < count, "Not an alternative");
+
+      T value(std::forward<Args>(args)...);
+      destroy();
+      construct<indexOf<T>>(std::move(value));
+    }
+
+    std::size_t index() const {
+      return tag();
+    }
+
+    template<typename T>
+    bool holds() const {
+      return tag() == indexOf<T>;
+    }
+
+    // The active alternative must be 'I'
+    template<std::size_t I>
+    decltype(auto) get() {
+
+      assert(tag() == I && "Not the active alternative");
+      if constexpr (tagInPointer) {
+        return reinterpret_cast<Alternative<I>>(storage & ~tagMask);
+      } else {
+        return (*address<I>());
+      }
+    }
+
+    template<std::size_t I>
+    decltype(auto) get() const {
+
+      assert(tag() == I && "Not the active alternative");
+      if constexpr (tagInPointer) {
+        return reinterpret_cast<Alternative<I>>(storage & ~tagMask);
+      } else {
+        return (*address<I>());
+      }
+    }
+
+    template<typename T>
+    decltype(auto) get() {
+      return get<indexOf<T>>();
+    }
+
+    template<typename T>
+    decltype(auto) get() const {
+      return get<indexOf<T>>();
+    }
+
+    // Calls 'f' on the active alternative; 'f' must return the same type for every alternative
+    template<typename F>
+    decltype(auto) visit(F&& f) {
+      return dispatch(std::forward<F>(f), *this, std::index_sequence_for<Ts...>{});
+    }
+
+    template<typename F>
+    decltype(auto) visit(F&& f) const {
+      return dispatch(std::forward<F>(f), *this, std::index_sequence_for<Ts...>{});
+    }
+
+  };
+
+}
+
+#endif // TYPES_TAGGEDUNION_H
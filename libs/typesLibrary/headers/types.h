@@ -22,6 +22,15 @@ namespace types {
     alias value();
   };
   
+  // Within the scope of 'Node', the names "Node" and "Type" refer to the data members, so they are accessed through 'this'
+  inline struct Node* Node::next() {
+    return this->Node;
+  }
+  
+  inline alias Node::value() {
+    return this->Type;
+  }
+  
 }
 
 #endif // TYPES_TYPES_H
@@ -0,0 +1,292 @@
+#ifndef TYPES_UNROLLEDLIST_H
+#define TYPES_UNROLLEDLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "types.h"
+
+namespace types {
+
+  /**
+   * An unrolled linked list is a linked list in which every node holds a small array of values instead of a single value. Compared to a list of
+   * individually allocated nodes (such as 'Node' above), it:
+   * - Takes one cache miss per block of values instead of one per value during traversal
+   * - Has no per-value pointer or allocator overhead
+   * - Still supports O(1) insertion and removal at a known position, up to the cost of shifting the values within one block
+   *
+   * Blocks are taken from a pool (a 'std::vector' of blocks) and linked by 32-bit indices into the pool instead of 64-bit pointers. This halves the
+   * size of the links and keeps them valid when the pool grows. Blocks that become empty are returned to a free list inside the pool for reuse.
+   *
+   * Every block except the last is kept at least half full (of 'blockCapacity / 2' values). Appending only starts a new block when the last one is
+   * full, and inserting into a full block splits it in half. When an erase leaves a block less than half full, it takes all the values of its
+   * successor if they fit into one block, and otherwise borrows the first values of its successor, which has more than enough to spare.
+   *
+   * Positions in the list are represented by cursors, which provide the same 'next()' and 'value()' interface as 'Node'. A cursor which is past the
+   * end of the list converts to 'false', just as the 'next()' of the last 'Node' is a null pointer. Any insertion or erasure invalidates all cursors.
+   */
+  template<typename T = alias, std::size_t BlockBytes = 128>
+  class UnrolledList {
+
+    static_assert(std::is_trivially_copyable_v<T>, "Values are shifted within blocks with memmove");
+
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+  public:
+
+    static constexpr std::size_t blockCapacity = (BlockBytes - 3 * sizeof(std::uint32_t)) / sizeof(T);
+    static_assert(blockCapacity >= 2, "Block size too small to hold at least two values");
+
+  private:
+
+    struct Block {
+      std::uint32_t next;
+      std::uint32_t prev;
+      std::uint32_t count;
+      T values[blockCapacity];
+    };
+
+    std::vector<Block> pool;
+    std::uint32_t head = npos;
+    std::uint32_t tail = npos;
+    std::uint32_t freeBlocks = npos;
+    std::size_t count = 0;
+
+    std::uint32_t allocateBlock() {
+
+      std::uint32_t b;
+      if (freeBlocks != npos) {
+        b = freeBlocks;
+        freeBlocks = pool[b].next;
+      } else {
+        b = static_cast<std::uint32_t>(pool.size());
+        pool.emplace_back();
+      }
+
+      pool[b].next = npos;
+      pool[b].prev = npos;
+      pool[b].count = 0;
+      return b;
+    }
+
+    void freeBlock(std::uint32_t b) {
+      pool[b].next = freeBlocks;
+      freeBlocks = b;
+    }
+
+    // Links a fresh block into the list after 'b' (or at the front, if 'b' is npos)
+    std::uint32_t insertBlockAfter(std::uint32_t b) {
+
+      std::uint32_t fresh = allocateBlock();
+      std::uint32_t next = (b == npos) ? head : pool[b].next;
+
+      pool[fresh].prev = b;
+      pool[fresh].next = next;
+      (b == npos ? head : pool[b].next) = fresh;
+      (next == npos ? tail : pool[next].prev) = fresh;
+
+      return fresh;
+    }
+
+    void unlinkBlock(std::uint32_t b) {
+
+      std::uint32_t prev = pool[b].prev;
+      std::uint32_t next = pool[b].next;
+
+      (prev == npos ? head : pool[prev].next) = next;
+      (next == npos ? tail : pool[next].prev) = prev;
+      freeBlock(b);
+    }
+
+  public:
+
+    class Cursor {
+
+      friend class UnrolledList;
+
+      const UnrolledList* list = nullptr;
+      std::uint32_t block = npos;
+      std::uint32_t index = 0;
+
+      Cursor(const UnrolledList* l, std::uint32_t b, std::uint32_t i): list(l), block(b), index(i) {}
+
+    public:
+
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T*;
+      using reference = const T&;
+
+      Cursor() = default;
+
+      Cursor next() const {
+
+        const Block& b = list->pool[block];
+        if (index + 1 < b.count) {
+          return {list, block, index + 1};
+        }
+
+        return {list, b.next, 0};
+      }
+
+      T value() const {
+        return list->pool[block].values[index];
+      }
+
+      explicit operator bool() const {
+        return block != npos;
+      }
+
+      const T& operator*() const {
+        return list->pool[block].values[index];
+      }
+
+      Cursor& operator++() {
+        *this = next();
+        return *this;
+      }
+
+      Cursor operator++(int) {
+        Cursor c = *this;
+        *this = next();
+        return c;
+      }
+
+      bool operator==(const Cursor& other) const {
+        return block == other.block && (block == npos || index == other.index);
+      }
+
+    };
+
+    using iterator = Cursor;
+    using const_iterator = Cursor;
+
+    UnrolledList() = default;
+
+    Cursor begin() const {
+      return {this, head, 0};
+    }
+
+    Cursor end() const {
+      return {this, npos, 0};
+    }
+
+    std::size_t size() const {
+      return count;
+    }
+
+    bool empty() const {
+      return count == 0;
+    }
+
+    void clear() {
+      pool.clear();
+      head = tail = freeBlocks = npos;
+      count = 0;
+    }
+
+    // Reserves pool capacity for at least 'n' values, assuming fully packed blocks
+    void reserve(std::size_t n) {
+      pool.reserve((n + blockCapacity - 1) / blockCapacity);
+    }
+
+    void push_back(T v) {
+
+      if (tail == npos || pool[tail].count == blockCapacity) {
+        insertBlockAfter(tail);
+      }
+
+      Block& b = pool[tail];
+      b.values[b.count++] = v;
+      ++count;
+    }
+
+    void push_front(T v) {
+      insert(begin(), v);
+    }
+
+    // Inserts 'v' before 'position' and returns a cursor to the inserted value; a full block is split in half to make room
+    Cursor insert(Cursor position, T v) {
+
+      if (!position) {
+        push_back(v);
+        return {this, tail, pool[tail].count - 1};
+      }
+
+      std::uint32_t b = position.block;
+      std::uint32_t i = position.index;
+
+      if (pool[b].count == blockCapacity) {
+        std::uint32_t fresh = insertBlockAfter(b);
+        std::uint32_t half = blockCapacity / 2;
+
+        std::memcpy(pool[fresh].values, pool[b].values + half, (blockCapacity - half) * sizeof(T));
+        pool[fresh].count = blockCapacity - half;
+        pool[b].count = half;
+
+        if (i > half) {
+          b = fresh;
+          i -= half;
+        }
+      }
+
+      Block& block = pool[b];
+      std::memmove(block.values + i + 1, block.values + i, (block.count - i) * sizeof(T));
+      block.values[i] = v;
+      ++block.count;
+      ++count;
+
+      return {this, b, i};
+    }
+
+    // Removes the value at 'position' and returns a cursor to the value which followed it
+    Cursor erase(Cursor position) {
+
+      std::uint32_t b = position.block;
+      std::uint32_t i = position.index;
+      Block& block = pool[b];
+
+      std::memmove(block.values + i, block.values + i + 1, (block.count - i - 1) * sizeof(T));
+      --block.count;
+      --count;
+
+      if (block.count == 0) {
+        std::uint32_t next = block.next;
+        unlinkBlock(b);
+        return {this, next, 0};
+      }
+
+      std::uint32_t next = block.next;
+      if (next != npos && block.count < blockCapacity / 2) {
+        Block& successor = pool[next];
+
+        if (block.count + successor.count <= blockCapacity) {
+          std::memcpy(block.values + block.count, successor.values, successor.count * sizeof(T));
+          block.count += successor.count;
+          unlinkBlock(next);
+        } else {
+          std::uint32_t borrowed = blockCapacity / 2 - block.count;
+          std::memcpy(block.values + block.count, successor.values, borrowed * sizeof(T));
+          std::memmove(successor.values, successor.values + borrowed, (successor.count - borrowed) * sizeof(T));
+          block.count += borrowed;
+          successor.count -= borrowed;
+        }
+      }
+
+      if (i < pool[b].count) {
+        return {this, b, i};
+      }
+
+      return {this, pool[b].next, 0};
+    }
+
+  };
+
+}
+
+#endif // TYPES_UNROLLEDLIST_H
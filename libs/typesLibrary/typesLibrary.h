@@ -2,13 +2,16 @@
 #define TYPES_LIBRARY_H
 
 #include "arrays.h"
+#include "enumReflection.h"
 #include "enumerations.h"
 #include "functions.h"
 #include "fundamental.h"
 #include "qualifiers.h"
 #include "pointers.h"
 #include "references.h"
+#include "taggedUnion.h"
 #include "types.h"
+#include "unrolledList.h"
 #include "unions.h"
 
 #endif // TYPES_LIBRARY_H
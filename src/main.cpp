@@ -1,3 +1,5 @@
+#include <iostream>
+
 #include "classesLibrary.h"
 #include "conceptsLibrary.h"
 #include "expressionsLibrary.h"
@@ -7,6 +9,19 @@
 #include "templatesLibrary.h"
 #include "typesLibrary.h"
 
+// Without arguments, lists the examples registered by every library; otherwise, runs the examples selected by the first argument (a substring or a
+// glob, e.g. "concepts/*")
 int main(int argc, char *argv[]) {
+
+  for (const auto& r : registry::examples()) {
+    if (argc < 2) {
+      std::cout << r.entry.name << '\n';
+    } else if (registry::matches(argv[1], r.entry.name)) {
+      // Flushed, since some examples write to the file descriptor directly (see "outputSink.h")
+      std::cout << "== " << r.entry.name << std::endl;
+      r.entry.run();
+    }
+  }
+
   return 0;
 }